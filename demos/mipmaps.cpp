@@ -0,0 +1,95 @@
+#include <iostream>
+#include <vector>
+
+#include "kaacore/clock.h"
+#include "kaacore/engine.h"
+#include "kaacore/log.h"
+#include "kaacore/nodes.h"
+#include "kaacore/resources.h"
+#include "kaacore/scenes.h"
+#include "kaacore/textures.h"
+
+struct MipmapsDemoScene : kaacore::Scene {
+    kaacore::ResourceReference<kaacore::Texture> plain_texture;
+    kaacore::ResourceReference<kaacore::Texture> mipped_texture;
+    std::vector<kaacore::NodePtr> nodes;
+    bool use_mips = true;
+    kaacore::Duration frames_duration = kaacore::Duration::zero();
+    uint32_t frames_count = 0;
+
+    MipmapsDemoScene(const char* filepath)
+    {
+        this->plain_texture =
+            kaacore::MemoryTexture::create(kaacore::load_image(filepath));
+        this->mipped_texture = kaacore::MemoryTexture::create(
+            kaacore::load_image(filepath),
+            {true, BGFX_SAMPLER_MIP_POINT | BGFX_SAMPLER_MIN_ANISOTROPIC}
+        );
+
+        for (int x = -20; x < 20; x++) {
+            for (int y = -15; y < 15; y++) {
+                auto node = kaacore::make_node();
+                node->shape(kaacore::Shape::Box({0.4, 0.4}));
+                node->position({x * 0.5 + 0.25, y * 0.5 + 0.25});
+                this->nodes.push_back(this->root_node.add_child(node));
+            }
+        }
+        this->_update_sprites();
+    }
+
+    void _update_sprites()
+    {
+        kaacore::Sprite sprite{
+            this->use_mips ? this->mipped_texture : this->plain_texture
+        };
+        for (auto& node : this->nodes) {
+            node->sprite(sprite);
+        }
+        KAACORE_APP_LOG_INFO("Mips enabled: {}", this->use_mips);
+    }
+
+    void update(const kaacore::Duration dt) override
+    {
+        this->frames_duration += dt;
+        this->frames_count++;
+        if (this->frames_duration.count() >= 1.) {
+            KAACORE_APP_LOG_INFO(
+                "Average frame time: {:.3f}ms",
+                1000. * this->frames_duration.count() / this->frames_count
+            );
+            this->frames_duration = kaacore::Duration::zero();
+            this->frames_count = 0;
+        }
+
+        for (auto const& event : this->get_events()) {
+            if (auto keyboard_key = event.keyboard_key()) {
+                if (keyboard_key->key() == kaacore::Keycode::q) {
+                    kaacore::get_engine()->quit();
+                    break;
+                } else if (keyboard_key->key() == kaacore::Keycode::m and
+                           keyboard_key->is_key_down()) {
+                    this->use_mips = not this->use_mips;
+                    this->_update_sprites();
+                }
+            }
+        }
+    }
+};
+
+extern "C" int
+main(int argc, char* argv[])
+{
+    if (argc != 2) {
+        std::cout << "Usage: <image_path>" << std::endl;
+        return 1;
+    }
+
+    kaacore::Engine eng({20, 15});
+    eng.window->size({800, 600});
+    eng.window->center();
+    MipmapsDemoScene scene{argv[1]};
+    scene.camera().position({0., 0.});
+    eng.run(&scene);
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "kaacore/files.h"
+#include "kaacore/memory.h"
+
+namespace kaacore {
+
+// Blobs are aligned, so uncompressed content can be read in place.
+constexpr size_t archive_alignment = 16;
+
+struct _ArchiveEntry {
+    uint64_t data_offset;
+    uint64_t stored_size;
+    uint64_t size;
+    uint32_t name_offset;
+    uint16_t name_length;
+    uint8_t compression;
+    uint8_t reserved;
+};
+
+// Read-only pack of many files mapped as a whole, with index sorted
+// by name so lookups are binary searches not touching filesystem.
+class Archive {
+  public:
+    const std::string path;
+
+    Archive(const std::string& path) noexcept(false);
+
+    size_t files_count() const;
+    bool contains(const std::string_view name) const;
+    // Uncompressed files are returned as views into archive mapping,
+    // LZ4-compressed ones are decompressed into new buffer.
+    std::optional<Memory> read(const std::string_view name) const;
+
+  private:
+    std::shared_ptr<MappedFile> _mapped_file;
+    std::vector<_ArchiveEntry> _entries;
+    const char* _names;
+
+    std::string_view _entry_name(const _ArchiveEntry& entry) const;
+    const _ArchiveEntry* _find(const std::string_view name) const;
+};
+
+struct ArchiveInput {
+    // name under which file is accessible in archive
+    std::string name;
+    std::string source_path;
+};
+
+// Files are LZ4-compressed only if it makes them smaller.
+bool
+write_archive(
+    const std::string& path, const std::vector<ArchiveInput>& inputs,
+    const bool compress
+) noexcept(false);
+
+// Files inside mounted archives are visible under mount point to
+// map_file, File and asset loaders (ImageTexture, Sound, FontData)
+// before real filesystem. Later mounts take precedence.
+void
+mount_archive(
+    const std::string& archive_path, const std::string& mount_point = ""
+) noexcept(false);
+void
+unmount_archive(const std::string& archive_path);
+std::optional<Memory>
+read_mounted_file(const std::string& path);
+
+} // namespace kaacore
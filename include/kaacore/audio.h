@@ -1,5 +1,11 @@
 #pragma once
 
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -7,6 +13,8 @@
 #include <SDL_mixer.h>
 
 #include "kaacore/resources.h"
+#include "kaacore/sound_cache.h"
+#include "kaacore/sound_streams.h"
 #include "kaacore/utils.h"
 
 namespace kaacore {
@@ -27,13 +35,28 @@ enum struct AudioStatus {
 
 struct SoundData : public Resource {
     const std::string path;
+    // Streamed sounds are decoded while playing, into buffer of
+    // given size allocated for each playback, instead of keeping
+    // whole decoded sound in memory. Only WAV files can be streamed.
+    const bool streaming;
+    const size_t stream_buffer_size;
     Mix_Chunk* _raw_sound;
+    // shared with sound cache and sound banks
+    std::shared_ptr<Mix_Chunk> _chunk;
 
     ~SoundData();
     static ResourceReference<SoundData> load(const std::string& path);
+    // Sounds are shared per path, buffer size of first load applies.
+    static ResourceReference<SoundData> load_streaming(
+        const std::string& path,
+        const size_t buffer_size = default_sound_stream_buffer_size
+    );
 
   private:
-    SoundData(const std::string& path);
+    SoundData(
+        const std::string& path, const bool streaming = false,
+        const size_t stream_buffer_size = 0
+    );
     virtual void _initialize() override;
     virtual void _uninitialize() override;
 
@@ -46,18 +69,37 @@ class Sound {
 
     ResourceReference<SoundData> _sound_data;
     double _volume;
+    uint16_t _max_voices = 0;
+    int _priority = 0;
 
     Sound(ResourceReference<SoundData> sound_data, double volume = 1.);
 
   public:
     Sound();
     static Sound load(const char* path, double volume = 1.);
+    // For long sounds (ambient loops, voice lines), short effects
+    // should be loaded fully.
+    static Sound load_streaming(
+        const char* path, double volume = 1.,
+        const size_t buffer_size = default_sound_stream_buffer_size
+    );
 
     operator bool() const;
     bool operator==(const Sound& other) const;
 
     double volume() const;
 
+    // Maximum number of playbacks of this sound at once, oldest one
+    // is stopped when exceeded. Zero means no limit.
+    uint16_t max_voices() const;
+    void max_voices(const uint16_t voices);
+    // When all channels are busy, new playback stops the oldest one
+    // with lowest priority not higher than its own (or is dropped).
+    int priority() const;
+    void priority(const int priority);
+
+    // Playing the same sound again within one frame only raises
+    // volume of the first playback.
     void play(double volume_factor = 1.);
 };
 
@@ -91,6 +133,39 @@ class SoundPlayback {
     bool stop();
 };
 
+// Decodes sounds in parallel on worker pool and keeps them decoded
+// while bank exists, so their Sounds can be created (also with
+// Sound::load) without decoding on engine thread.
+class SoundBank {
+  public:
+    SoundBank() = default;
+    SoundBank(const std::vector<std::string>& paths);
+    ~SoundBank();
+    SoundBank(const SoundBank&) = delete;
+    SoundBank& operator=(const SoundBank&) = delete;
+
+    // Starts decoding of sounds not yet in the bank
+    void preload(const std::vector<std::string>& paths);
+    size_t size() const;
+    // Includes sounds which failed to load
+    size_t loaded_count() const;
+    // Fraction of loaded sounds, 1 for empty bank
+    double progress() const;
+    bool is_loaded() const;
+    void wait_until_loaded();
+    // Blocks until given sound is decoded
+    Sound get(const std::string& path, double volume = 1.);
+
+  private:
+    struct _BankedSound {
+        std::string path;
+        std::future<std::shared_ptr<Mix_Chunk>> pending_chunk;
+        std::shared_ptr<Mix_Chunk> chunk;
+    };
+
+    std::vector<_BankedSound> _sounds;
+};
+
 struct MusicData : public Resource {
     const std::string path;
     Mix_Music* _raw_music;
@@ -140,11 +215,21 @@ struct _MusicState {
     Music current_music;
 };
 
+struct AudioVoicesStats {
+    uint16_t active_voices;
+    // totals since audio was initialized
+    uint64_t stolen_voices;
+    uint64_t dropped_voices;
+    uint64_t deduplicated_voices;
+};
+
 struct _ChannelState {
     double requested_volume;
     Sound current_sound;
     PlaybackUid playback_uid;
     bool paused;
+    // order of playbacks start, used to pick voice to steal
+    uint64_t start_order;
 
     // we keep track if channel was stopped manually, since
     // there is a possibility that manually stopped channel
@@ -155,10 +240,21 @@ struct _ChannelState {
     void reset();
 };
 
+// Picks channel with the lowest priority not higher than given one,
+// the oldest playback among equal priorities. Returns -1 if all
+// channels play sounds with higher priority.
+int
+_select_voice_to_steal(
+    const std::vector<_ChannelState>& channels_state, const int priority
+);
+
+struct _SoundStream;
+
 class AudioManager {
     friend class Engine;
     friend class Sound;
     friend struct SoundData;
+    friend class SoundBank;
     friend class SoundPlayback;
     friend class Music;
     friend struct MusicData;
@@ -170,15 +266,50 @@ class AudioManager {
     _MusicState _music_state;
     std::vector<_ChannelState> _channels_state;
 
+    // streamed sounds are played on channels looping silent chunk,
+    // whose samples are replaced by channel effect
+    std::vector<uint8_t> _stream_carrier_samples;
+    Mix_Chunk* _stream_carrier_chunk = nullptr;
+    SDL_AudioFormat _mixer_format = MIX_DEFAULT_FORMAT;
+    uint8_t _mixer_channels = 2;
+    int _mixer_frequency = MIX_DEFAULT_FREQUENCY;
+    std::vector<std::unique_ptr<_SoundStream>> _streams;
+    std::mutex _streams_lock;
+    std::condition_variable _streams_condition;
+    std::thread _streaming_thread;
+    bool _streaming_running = false;
+
+    std::unique_ptr<SoundCache> _sound_cache;
+
+    uint64_t _started_voices = 0;
+    AudioVoicesStats _voices_stats = {};
+    AudioVoicesStats _reported_voices_stats = {};
+    // fire-and-forget playbacks started in current frame
+    std::vector<std::pair<const SoundData*, ChannelId>> _frame_playbacks;
+
     Mix_Chunk* load_raw_sound(const char* path);
+    // Thread-safe, returns decoded sound from cache if possible
+    std::shared_ptr<Mix_Chunk> _load_sound(const std::string& path);
     Mix_Music* load_raw_music(const char* path);
 
     std::pair<ChannelId, PlaybackUid> play_sound(
-        const Sound& sound, const double volume_factor = 1., const int loops = 1
+        const Sound& sound, const double volume_factor = 1.,
+        const int loops = 1, const bool deduplicate = false
     );
     void play_music(const Music& music, const double volume_factor = 1.);
     AudioStatus music_state();
 
+    int _play_stream(
+        const SoundData& sound_data, const int loops, const int channel = -1
+    );
+    int _start_channel(const Sound& sound, const int loops, const int channel);
+    // Returns channel freed for the sound or -1 if it should be dropped
+    int _steal_voice(const Sound& sound);
+    // Clears same-frame deduplication and pushes voices statistics,
+    // called by engine after every frame.
+    void _end_frame();
+    void _run_streaming();
+
     AudioStatus _check_playback(
         const ChannelId& channel_id, const PlaybackUid& playback_uid
     );
@@ -200,6 +331,7 @@ class AudioManager {
 
     void _handle_music_finished();
     void _handle_channel_finished(ChannelId channel_id);
+    void _handle_stream_finished(ChannelId channel_id);
 
   public:
     AudioManager();
@@ -216,6 +348,16 @@ class AudioManager {
 
     uint16_t mixing_channels() const;
     void mixing_channels(const uint16_t channels);
+
+    // Decoded sounds are kept in memory as long as they are used
+    // (by sounds or sound banks), unused ones are kept in the cache
+    // until their total size exceeds the budget. Usage counts
+    // only unused sounds.
+    size_t sound_cache_budget() const;
+    void sound_cache_budget(const size_t budget);
+    size_t sound_cache_usage() const;
+
+    AudioVoicesStats voices_stats() const;
 };
 
 } // namespace kaacore
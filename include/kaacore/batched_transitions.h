@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "kaacore/clock.h"
+#include "kaacore/easings.h"
+
+namespace kaacore {
+
+class Node;
+struct NodeTransitionRunner;
+
+enum struct BatchedTransitionAttribute : uint8_t {
+    none = 0,
+    position,
+    rotation,
+    scale,
+    color,
+};
+
+struct BatchedTransitionParams {
+    BatchedTransitionAttribute attribute;
+    // values are packed into dvec4, unused components are zeroed
+    glm::dvec4 origin_value;
+    glm::dvec4 destination_value;
+    Duration duration;
+    Duration internal_duration;
+    uint32_t loops;
+    bool back_and_forth;
+    Easing easing;
+};
+
+inline glm::dvec4
+pack_batched_transition_value(const double value)
+{
+    return {value, 0., 0., 0.};
+}
+
+inline glm::dvec4
+pack_batched_transition_value(const glm::dvec2 value)
+{
+    return {value.x, value.y, 0., 0.};
+}
+
+inline glm::dvec4
+pack_batched_transition_value(const glm::dvec4 value)
+{
+    return value;
+}
+
+template<typename T>
+struct _BatchedAttributeTransitions {
+    std::vector<Node*> nodes;
+    std::vector<NodeTransitionRunner*> runners;
+    std::vector<T> origin_values;
+    std::vector<T> destination_values;
+    // times are kept in microseconds
+    std::vector<HighPrecisionDuration::rep> start_times;
+    std::vector<double> durations;
+    std::vector<double> internal_durations;
+    std::vector<uint32_t> loops;
+    std::vector<uint8_t> back_and_forth;
+    std::vector<Easing> easings;
+
+    // per-frame buffers
+    std::vector<double> progress;
+    std::vector<uint8_t> finished;
+
+    size_t size() const { return this->nodes.size(); }
+    void swap_remove(const uint32_t index);
+};
+
+// Evaluates plain attribute transitions (position, rotation, scale, color)
+// of all nodes in scene in bulk, instead of stepping them node by node.
+// Transition runners are registered here on their first step.
+class BatchedTransitionsManager {
+  public:
+    BatchedTransitionsManager() = default;
+    BatchedTransitionsManager(const BatchedTransitionsManager&) = delete;
+    BatchedTransitionsManager& operator=(const BatchedTransitionsManager&) =
+        delete;
+
+    void add(
+        Node* node, NodeTransitionRunner* runner,
+        const BatchedTransitionParams& params,
+        const HighPrecisionDuration elapsed_time
+    );
+    void remove(NodeTransitionRunner* runner);
+
+    HighPrecisionDuration elapsed_time(const NodeTransitionRunner* runner
+    ) const;
+    void elapsed_time(
+        NodeTransitionRunner* runner, const HighPrecisionDuration elapsed_time
+    );
+    // packed origin and destination values
+    std::pair<glm::dvec4, glm::dvec4>
+    transition_values(const NodeTransitionRunner* runner) const;
+
+    size_t size() const;
+    void process(const HighPrecisionDuration dt);
+
+  private:
+    HighPrecisionDuration _clock = 0us;
+    _BatchedAttributeTransitions<glm::dvec2> _position_transitions;
+    _BatchedAttributeTransitions<double> _rotation_transitions;
+    _BatchedAttributeTransitions<glm::dvec2> _scale_transitions;
+    _BatchedAttributeTransitions<glm::dvec4> _color_transitions;
+    std::vector<std::pair<Node*, NodeTransitionRunner*>> _finished_transitions;
+
+    template<typename Self, typename Func>
+    static void _visit_batch(
+        Self& self, const BatchedTransitionAttribute attribute, Func&& func
+    );
+    template<typename T, typename Func>
+    void _process_batch(_BatchedAttributeTransitions<T>& batch, Func&& apply);
+};
+
+} // namespace kaacore
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace kaacore {
+
+// LZ4 block format (without frame headers), compatible with
+// LZ4_compress_default / LZ4_decompress_safe.
+size_t
+lz4_compress_bound(const size_t size);
+std::vector<std::byte>
+lz4_compress(const std::byte* data, const size_t size);
+// Returns false if input is malformed or doesn't decompress
+// to exactly `decompressed_size` bytes.
+bool
+lz4_decompress(
+    const std::byte* data, const size_t size, std::byte* decompressed,
+    const size_t decompressed_size
+);
+
+} // namespace kaacore
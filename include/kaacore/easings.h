@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 #include <glm/glm.hpp>
 
 namespace kaacore {
@@ -41,6 +43,15 @@ enum class Easing {
 double
 ease(const Easing easing, const double progress);
 
+// Evaluates the same easing for `count` progress values, results match
+// `ease`. Kernels are branchless loops, so they can be auto-vectorized.
+// `output` may point to the same memory as `progress`.
+void
+ease_batch(
+    const Easing easing, const double* progress, double* output,
+    const size_t count
+);
+
 template<typename T>
 T
 ease_between(const Easing easing, const double progress, const T a, const T b)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -7,6 +8,8 @@
 #include <bgfx/bgfx.h>
 #include <bimg/decode.h>
 
+#include "kaacore/memory.h"
+
 namespace kaacore {
 
 class File {
@@ -17,4 +20,36 @@ class File {
     File(const std::string& path) noexcept(false);
 };
 
+// Read-only memory mapping of whole file.
+class MappedFile {
+  public:
+    const std::string path;
+
+    MappedFile(const std::string& path) noexcept(false);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::byte* data() const;
+    size_t size() const;
+
+  private:
+    const std::byte* _data = nullptr;
+    size_t _size = 0;
+#if _WIN32
+    void* _file_handle = nullptr;
+    void* _mapping_handle = nullptr;
+#else
+    int _file_descriptor = -1;
+#endif
+};
+
+// Zero-copy view of file content, file stays mapped as long as
+// any copy of returned memory is alive.
+Memory
+map_file(const std::string& path) noexcept(false);
+
+bool
+write_file(const std::string& path, const std::byte* data, const size_t size);
+
 } // namespace kaacore
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "kaacore/fonts.h"
+
+namespace kaacore {
+
+// Directory in which baked font atlases are persisted, empty string
+// disables the cache. Defaults to value of KAACORE_FONT_CACHE_DIR
+// environment variable. Directory must exist.
+std::string
+get_font_cache_directory();
+void
+set_font_cache_directory(const std::string& directory);
+
+// Key covers font file content and all parameters affecting baking
+uint64_t
+calculate_font_cache_key(const std::byte* font_data, const size_t size);
+std::string
+get_font_cache_path(const std::string& directory, const uint64_t key);
+
+// Returns nullopt if cache file is missing or invalid
+std::optional<BakedFontAtlas>
+load_font_cache(const std::string& directory, const uint64_t key);
+bool
+store_font_cache(
+    const std::string& directory, const uint64_t key,
+    const BakedFontAtlas& atlas
+);
+
+} // namespace kaacore
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <array>
 #include <cmath>
 #include <functional>
+#include <list>
+#include <memory>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -21,6 +27,8 @@ void
 initialize_fonts();
 void
 uninitialize_fonts();
+void
+push_fonts_statistics();
 
 typedef std::vector<stbtt_packedchar> BakedFontData;
 typedef uint32_t UnicodeCodepoint;
@@ -33,6 +41,13 @@ const size_t font_baker_texture_max_height = 10240;
 const size_t font_baker_pixel_height = 80;
 const UnicodeCodepoint font_baker_first_glyph = 32;
 const size_t font_baker_glyphs_count = 96;
+// size of atlas page created once text needs glyphs
+// outside of range baked at load time
+const size_t font_atlas_page_size = 2048;
+const UnicodeCodepoint font_fallback_glyph = '?';
+// max number of text layouts cached by single font
+const size_t text_layout_cache_capacity = 256;
+const UnicodeCodepoint unicode_replacement_character = 0xFFFD;
 
 // padding field added around glyph
 const int font_sdf_padding = 5;
@@ -44,6 +59,10 @@ const int font_sdf_edge_value = 180;
 const float font_sdf_pixel_dist_scale =
     font_sdf_edge_value / double(font_sdf_padding);
 
+// Invalid sequences are decoded as `unicode_replacement_character`.
+std::vector<UnicodeCodepoint>
+decode_utf8(const std::string& text);
+
 struct FontMetrics {
     FontMetrics() = default;
     inline FontMetrics(
@@ -59,6 +78,18 @@ struct FontMetrics {
     double line_gap;
 };
 
+// R8 atlas image, glyphs data (in order of baked codepoints)
+// and unscaled font metrics
+typedef std::tuple<bimg::ImageContainer*, BakedFontData, FontMetrics>
+    BakedFontAtlas;
+
+// Glyphs are rasterized in parallel on worker pool
+BakedFontAtlas
+bake_font_texture(
+    const stbtt_fontinfo& font_info, const double font_baking_scale,
+    const std::vector<UnicodeCodepoint>& codepoints
+);
+
 struct FontRenderGlyph {
     UnicodeCodepoint codepoint;
     glm::dvec2 offset;
@@ -79,6 +110,8 @@ struct FontRenderGlyph {
     );
 
     bool has_size() const;
+    BoundingBox<double> bounding_box(const FontMetrics font_metrics) const;
+    std::array<StandardVertexData, 4> quad_vertices() const;
 
     static void arrange_glyphs(
         std::vector<FontRenderGlyph>& render_glyphs, const double indent,
@@ -90,10 +123,46 @@ struct FontRenderGlyph {
     );
 };
 
+struct TextLayoutParams {
+    std::string content;
+    double font_size;
+    double line_height;
+    double line_width;
+    double first_line_indent;
+
+    bool operator==(const TextLayoutParams& other) const;
+};
+
+struct TextLayoutParamsHash {
+    size_t operator()(const TextLayoutParams& params) const;
+};
+
+// Arranged glyphs and generated shape of text, shared (read-only)
+// by all text nodes displaying it.
+struct TextLayout {
+    TextLayoutParams params;
+    std::vector<UnicodeCodepoint> codepoints;
+    std::vector<FontRenderGlyph> render_glyphs;
+    Shape shape;
+    ResourceReference<Texture> texture;
+};
+
+struct TextLayoutCacheStats {
+    size_t hits;
+    size_t misses;
+    size_t size;
+};
+
+struct _FontDynamicAtlas;
+
 class FontData : public Resource {
   public:
     const std::string path;
+    // glyphs from range baked at load time
     BakedFontData baked_font;
+    // texture containing all glyphs baked so far, it's replaced
+    // (once) by bigger, updatable atlas when first glyph outside
+    // of the baked range is requested
     ResourceReference<Texture> baked_texture;
     FontMetrics font_metrics;
 
@@ -106,13 +175,53 @@ class FontData : public Resource {
     std::vector<FontRenderGlyph> generate_render_glyphs(
         const std::string& text, const double scale_factor
     );
+    // Updates render glyphs in place to match given codepoints, glyphs
+    // before `first_changed_index` are kept unless atlas texture gets
+    // replaced. Returns index of first regenerated glyph.
+    size_t update_render_glyphs(
+        const std::vector<UnicodeCodepoint>& codepoints,
+        const double scale_factor, std::vector<FontRenderGlyph>& render_glyphs,
+        size_t first_changed_index
+    );
+    // Returns cached layout or generates new one, `previous_layout`
+    // (if given) is used to regenerate only glyphs that changed.
+    std::shared_ptr<const TextLayout> get_text_layout(
+        const TextLayoutParams& params,
+        const TextLayout* previous_layout = nullptr
+    );
     inline FontMetrics metrics() { return this->font_metrics; }
+    size_t dynamic_glyphs_count() const;
+    TextLayoutCacheStats text_layout_cache_stats() const;
 
   private:
+    Memory _font_source;
+    stbtt_fontinfo _font_info;
+    double _font_baking_scale;
+    ResourceReference<MemoryTexture> _initial_texture;
+    std::unordered_map<UnicodeCodepoint, stbtt_packedchar> _dynamic_glyphs;
+    // codepoints missing in font or not fitting in atlas
+    std::unordered_set<UnicodeCodepoint> _unavailable_glyphs;
+    std::unique_ptr<_FontDynamicAtlas> _dynamic_atlas;
+
+    // most recently used layouts are kept at front
+    std::list<std::shared_ptr<const TextLayout>> _text_layouts;
+    std::unordered_map<
+        TextLayoutParams,
+        std::list<std::shared_ptr<const TextLayout>>::iterator,
+        TextLayoutParamsHash>
+        _text_layouts_index;
+    size_t _text_layout_cache_hits = 0;
+    size_t _text_layout_cache_misses = 0;
+
     FontData(const std::string& path);
-    FontData(
-        const ResourceReference<Texture> baked_texture,
-        const BakedFontData baked_font, const FontMetrics font_metrics
+    FontData(const Memory& font_source);
+    void _bake();
+    const stbtt_packedchar* _find_glyph(const UnicodeCodepoint codepoint
+    ) const;
+    void _bake_missing_glyphs(const std::vector<UnicodeCodepoint>& codepoints);
+    bool _create_dynamic_atlas();
+    std::shared_ptr<const TextLayout> _make_text_layout(
+        const TextLayoutParams& params, const TextLayout* previous_layout
     );
     virtual void _initialize() override;
     virtual void _uninitialize() override;
@@ -122,12 +231,14 @@ class FontData : public Resource {
     friend void uninitialize_fonts();
 };
 
+class Node;
 class TextNode;
 
 class Font {
   public:
     Font();
     static Font load(const std::string& font_filepath);
+    ResourceReference<FontData> font_data() const;
 
     bool operator==(const Font& other);
 
@@ -154,9 +265,11 @@ class TextNode {
     double _first_line_indent;
     Font _font;
 
-    std::vector<FontRenderGlyph> _render_glyphs;
+    std::shared_ptr<const TextLayout> _layout;
+    size_t _quads_count = 0;
 
     void _update_shape();
+    void _update_node_shape(Node* node, const Shape& layout_shape);
 
   public:
     TextNode();
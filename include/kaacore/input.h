@@ -359,6 +359,7 @@ enum class EventType {
     channel_finished,
 
     // Private custom events
+    _sound_stream_finished,
     _sentinel,
 };
 
@@ -23,9 +23,11 @@ constexpr std::array _log_categories{
     "nodes"sv, "node_ptr"sv, "engine"sv, "files"sv, "log"sv, "renderer"sv,
     "images"sv, "input"sv, "audio"sv, "scenes"sv, "shapes"sv, "physics"sv,
     "resources"sv, "resources_manager"sv, "sprites"sv, "window"sv, "geometry"sv,
-    "fonts"sv, "timers"sv, "transitions"sv, "node_transitions"sv, "camera"sv,
-    "views"sv, "spatial_index"sv, "threading"sv, "utils"sv, "embedded_data"sv,
-    "easings"sv, "shaders"sv, "statistics"sv, "draw_unit"sv, "draw_queue"sv,
+    "fonts"sv, "font_cache"sv, "timers"sv, "transitions"sv,
+    "node_transitions"sv, "camera"sv, "views"sv, "spatial_index"sv,
+    "threading"sv, "utils"sv, "embedded_data"sv, "easings"sv, "shaders"sv,
+    "statistics"sv, "draw_unit"sv, "draw_queue"sv, "snapshots"sv,
+    "archives"sv, "compression"sv, "sound_streams"sv, "tracing"sv,
     // special-purpose categories
     "other"sv, "app"sv, "wrapper"sv, "tools"sv
 };
@@ -16,6 +16,9 @@ class Memory {
     bool operator==(const Memory& other);
     static Memory copy(const std::byte* memory, std::size_t size);
     static Memory reference(const std::byte* memory, std::size_t size);
+    // Shares ownership with given pointer, which may alias bigger
+    // object keeping the memory alive (e.g. mapped file).
+    static Memory share(std::shared_ptr<std::byte> memory, std::size_t size);
 
     void destroy();
     const std::byte* get() const;
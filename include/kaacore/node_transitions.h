@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #include <glm/glm.hpp>
 
@@ -92,6 +93,31 @@ struct NodeAttributeTransitionState : TransitionStateBase {
     {}
 };
 
+template<
+    typename N, N Node::*N_member, typename T_getter, T_getter (N::*F_getter)()>
+inline constexpr BatchedTransitionAttribute batched_transition_attribute =
+    BatchedTransitionAttribute::none;
+
+template<>
+inline constexpr BatchedTransitionAttribute batched_transition_attribute<
+    Node, nullptr, glm::dvec2, &Node::position> =
+    BatchedTransitionAttribute::position;
+
+template<>
+inline constexpr BatchedTransitionAttribute
+    batched_transition_attribute<Node, nullptr, double, &Node::rotation> =
+        BatchedTransitionAttribute::rotation;
+
+template<>
+inline constexpr BatchedTransitionAttribute
+    batched_transition_attribute<Node, nullptr, glm::dvec2, &Node::scale> =
+        BatchedTransitionAttribute::scale;
+
+template<>
+inline constexpr BatchedTransitionAttribute
+    batched_transition_attribute<Node, nullptr, glm::dvec4, &Node::color> =
+        BatchedTransitionAttribute::color;
+
 template<
     typename N, N Node::*N_member, typename T_getter, T_getter (N::*F_getter)(),
     typename T_setter, void (N::*F_setter)(T_setter)>
@@ -138,6 +164,30 @@ class NodeAttributeTransition : public NodeTransitionCustomizable {
             glm::mix(state->origin_value, state->destination_value, t);
         set_node_property<N, N_member, T_setter, F_setter>(node, new_value);
     }
+
+    std::optional<BatchedTransitionParams> batched_params(NodePtr node) const
+    {
+        constexpr auto attribute =
+            batched_transition_attribute<N, N_member, T_getter, F_getter>;
+        if constexpr (attribute == BatchedTransitionAttribute::none) {
+            return std::nullopt;
+        } else {
+            const T origin_value =
+                get_node_property<N, N_member, T_getter, F_getter>(node);
+            return BatchedTransitionParams{
+                attribute,
+                pack_batched_transition_value(origin_value),
+                pack_batched_transition_value(calculate_attribute_advancement(
+                    origin_value, this->_value_advance, this->_advance_method
+                )),
+                this->duration,
+                this->internal_duration,
+                this->warping.loops,
+                this->warping.back_and_forth,
+                this->_easing
+            };
+        }
+    }
 };
 
 typedef NodeAttributeTransition<
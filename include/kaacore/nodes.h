@@ -355,6 +355,9 @@ class Node {
     friend struct HitboxNode;
     friend struct NodeSpatialData;
     friend class SpatialIndex;
+    friend class SimulationSnapshot;
+    friend class BatchedTransitionsManager;
+    friend class TextNode;
     friend constexpr Node* container_node(const NodeSpatialData*);
 };
 
@@ -192,6 +192,7 @@ class SpaceNode {
     friend class BodyNode;
     friend class HitboxNode;
     friend class Scene;
+    friend class SimulationSnapshot;
     friend void cp_call_post_step_callbacks(cpSpace*, void*, void*);
 };
 
@@ -294,6 +295,7 @@ class BodyNode {
     friend class Node;
     friend class HitboxNode;
     friend class Scene;
+    friend class SimulationSnapshot;
 
     friend void _velocity_update_wrapper(cpBody*, cpVect, cpFloat, cpFloat);
     friend void _position_update_wrapper(cpBody*, cpFloat);
@@ -335,14 +337,19 @@ class HitboxNode {
     ~HitboxNode();
 
     void update_physics_shape();
+    void update_physics_shape_transformation();
+    void _rebuild_physics_shape(const Transformation& transformation);
     void attach_to_simulation();
     void detach_from_simulation();
     void _mark_hitbox_chain();
     Node* _find_nearest_parent(const NodeType type) const;
 
     cpShape* _cp_shape = nullptr;
+    // inherited scale that current cpShape was built with
+    glm::dvec2 _cp_shape_scale = {1., 1.};
 
     friend class Node;
+    friend class SimulationSnapshot;
 };
 
 } // namespace kaacore
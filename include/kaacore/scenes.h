@@ -1,11 +1,13 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <set>
 #include <vector>
 
 #include <glm/glm.hpp>
 
+#include "kaacore/batched_transitions.h"
 #include "kaacore/camera.h"
 #include "kaacore/clock.h"
 #include "kaacore/draw_queue.h"
@@ -24,6 +26,8 @@ class Scene {
     using NodesQueue = std::vector<Node*>;
 
   public:
+    // declared before root_node, so it outlives transitions of all nodes
+    BatchedTransitionsManager batched_transitions;
     Node root_node;
     RenderPassesManager render_passes;
     ViewportsManager viewports;
@@ -62,6 +66,15 @@ class Scene {
     double time_scale() const;
     void time_scale(const double scale);
 
+    // When set, every frame advances the scene by exactly this step
+    // (time scale is ignored), making simulation independent of frame timing.
+    std::optional<HighPrecisionDuration> fixed_time_step() const;
+    void fixed_time_step(const std::optional<HighPrecisionDuration> step);
+
+    // Advances physics and nodes (lifetimes, transitions) without rendering,
+    // intended for re-simulating frames after restoring a snapshot.
+    void step_simulation(const HighPrecisionDuration dt);
+
     virtual void on_attach();
     virtual void on_enter();
     virtual void update(const Duration dt);
@@ -72,6 +85,7 @@ class Scene {
 
   private:
     double _time_scale = 1.;
+    std::optional<HighPrecisionDuration> _fixed_time_step = std::nullopt;
     Duration _last_dt = 0s;
     Duration _total_time = 0s;
     NodesQueue _nodes_remove_queue;
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "kaacore/node_ptr.h"
+#include "kaacore/transitions.h"
+
+namespace kaacore {
+
+// Captures simulation-relevant state of a space node subtree:
+// bodies (position, velocity, angular data, accumulated force and torque),
+// hitboxes (collision filtering and material parameters), transformation
+// and color of nodes and times of running node transitions (keyed by
+// process-wide transition slots). Attribute transitions are restored with
+// their original origin values, other transitions that were finished
+// or replaced since capture are prepared again from restored node
+// attributes. Nodes are identified by their position in the subtree,
+// so snapshot can only be restored onto the same (or identically
+// structured) tree.
+// Collision contact caches of the chipmunk space are not part of the snapshot.
+class SimulationSnapshot {
+  public:
+    SimulationSnapshot() = default;
+
+    static SimulationSnapshot capture(NodePtr space_node);
+    void restore(NodePtr space_node) const;
+
+    const std::vector<std::byte>& data() const;
+    size_t size() const;
+    operator bool() const;
+
+  private:
+    std::vector<std::byte> _data;
+    // transitions are referenced from binary data by index
+    std::vector<NodeTransitionHandle> _transition_handles;
+
+    static const std::vector<Node*>& _collect_nodes(Node* space_node);
+};
+
+} // namespace kaacore
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <SDL_mixer.h>
+
+namespace kaacore {
+
+// Decoded sounds kept by cache after they are no longer used
+constexpr size_t default_sound_cache_budget = 64 * 1024 * 1024;
+
+struct _SoundCacheState;
+
+// Shares decoded sounds by path. Sounds are kept in memory as long as
+// returned chunks are used, unused ones are kept until their total size
+// exceeds the budget, least recently used are released first.
+// Thread-safe, returned chunks can outlive the cache.
+class SoundCache {
+  public:
+    SoundCache(const size_t budget = default_sound_cache_budget);
+    ~SoundCache();
+    SoundCache(const SoundCache&) = delete;
+    SoundCache& operator=(const SoundCache&) = delete;
+
+    // Returns nullptr if sound is not cached
+    std::shared_ptr<Mix_Chunk> get(const std::string& path);
+    // Returns already cached chunk if the same sound was decoded
+    // in the meantime
+    std::shared_ptr<Mix_Chunk>
+    insert(const std::string& path, std::shared_ptr<Mix_Chunk> chunk);
+    bool contains(const std::string& path) const;
+
+    size_t budget() const;
+    void budget(const size_t budget);
+    // Total size of unused sounds
+    size_t usage() const;
+
+  private:
+    std::shared_ptr<_SoundCacheState> _state;
+};
+
+} // namespace kaacore
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <SDL.h>
+
+#include "kaacore/memory.h"
+
+namespace kaacore {
+
+// Amount of decoded audio buffered by each streamed playback
+// (about 0.37s of 44.1kHz 16-bit stereo).
+constexpr size_t default_sound_stream_buffer_size = 64 * 1024;
+
+// Decodes PCM or float WAV file in chunks, converting samples
+// to given output format. File is read through memory mapping,
+// so only currently converted chunk takes memory.
+class WavStreamDecoder {
+  public:
+    // `loops` follows SoundPlayback convention, 0 loops forever
+    WavStreamDecoder(
+        const std::string& path, const SDL_AudioFormat format,
+        const uint8_t channels, const int frequency, const int loops = 1
+    ) noexcept(false);
+    ~WavStreamDecoder();
+    WavStreamDecoder(const WavStreamDecoder&) = delete;
+    WavStreamDecoder& operator=(const WavStreamDecoder&) = delete;
+
+    // Size of single sample frame in output format
+    size_t frame_size() const;
+    // Decodes up to `size` bytes (rounded down to whole frames),
+    // returns 0 once all loops are played.
+    size_t decode(std::byte* output, const size_t size);
+
+  private:
+    Memory _file;
+    const std::byte* _samples = nullptr;
+    size_t _samples_size = 0;
+    size_t _position = 0;
+    size_t _input_chunk_size = 0;
+    size_t _frame_size = 0;
+    int _loops_left;
+    bool _flushed = false;
+    SDL_AudioStream* _stream = nullptr;
+};
+
+} // namespace kaacore
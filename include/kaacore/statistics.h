@@ -2,8 +2,11 @@
 
 #include <array>
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -14,6 +17,8 @@
 namespace kaacore {
 
 constexpr size_t statistic_tracker_buffer_size = 50u;
+// Samples each thread can push between merges
+constexpr size_t statistics_thread_buffer_size = 4096u;
 constexpr uint16_t udp_stats_exporter_default_port = 9771;
 static const char* udp_stats_exporter_env_name = "KAACORE_STATS_EXPORT_UDP";
 
@@ -24,14 +29,74 @@ struct StatisticAnalysis {
     double max_value;
     double min_value;
     double standard_deviation;
+    // percentiles over histogram window (NaN when it's empty)
+    uint64_t window_samples_count;
+    double percentile_50;
+    double percentile_95;
+    double percentile_99;
+    double percentile_99_9;
+};
+
+// Log-linear histogram (as used by HdrHistogram): values are counted
+// in buckets whose width grows with magnitude, so percentiles have
+// relative error below 2^-significant_bits regardless of value range.
+class StatisticHistogram {
+  public:
+    // Values are recorded as multiples of `resolution`,
+    // negative ones are recorded as zero.
+    StatisticHistogram(
+        const double resolution = 1e-6, const uint8_t significant_bits = 7
+    );
+
+    void record(const double value);
+    void merge(const StatisticHistogram& other);
+    void reset();
+    uint64_t count() const;
+    double min_value() const;
+    double max_value() const;
+    // `percentile` is in [0, 100] range, returns NaN for empty histogram
+    double percentile(const double percentile) const;
+
+  private:
+    double _resolution;
+    uint8_t _significant_bits;
+    uint64_t _count = 0;
+    double _min_value;
+    double _max_value;
+    // grown up to the highest recorded bucket
+    std::vector<uint32_t> _counts;
+
+    size_t _bucket_index(const uint64_t units) const;
+    double _bucket_value(const size_t index) const;
+};
+
+enum struct StatisticWindowReset {
+    // histogram is never cleared (unless reset explicitly)
+    cumulative,
+    // histogram is cleared once window is full, percentiles come
+    // from the last full window
+    tumbling,
+    // histogram covers between 3/4 and whole window of latest samples
+    sliding,
+};
+
+struct StatisticWindowOptions {
+    // number of samples covered by percentiles
+    uint32_t length = 1000u;
+    StatisticWindowReset reset = StatisticWindowReset::sliding;
+    // smallest distinguishable value, microsecond fits time stats
+    double resolution = 1e-6;
+    uint8_t significant_bits = 7;
 };
 
 class FrameStatisticTracker {
   public:
-    FrameStatisticTracker();
+    FrameStatisticTracker(const StatisticWindowOptions& window_options = {});
     void push_value(const double value);
     StatisticAnalysis analyse() const;
     double last_value() const;
+    // Clears histogram window, recent values buffer is kept
+    void reset_window();
 
   private:
     std::array<double, statistic_tracker_buffer_size> _values_ring_buffer;
@@ -39,21 +104,63 @@ class FrameStatisticTracker {
     decltype(_values_ring_buffer)::iterator _last_value_position;
     decltype(_values_ring_buffer)::iterator _next_value_position;
     size_t _size;
+
+    StatisticWindowOptions _window_options;
+    // sub-windows, oldest one is cleared when current one fills
+    std::vector<StatisticHistogram> _histograms;
+    size_t _current_histogram = 0;
+    uint32_t _histogram_capacity;
 };
 
+typedef uint32_t StatHandle;
+
+class SpscRingBuffer;
+
+// Values pushed by handle go to buffer of the pushing thread, without
+// locking or allocating, and are merged into trackers by `flush`
+// (called by engine after every frame) or when buffer gets full.
 class StatisticsManager {
   public:
+    StatisticsManager();
+    ~StatisticsManager();
+    StatisticsManager(const StatisticsManager&) = delete;
+    StatisticsManager& operator=(const StatisticsManager&) = delete;
+
+    // Returns the same handle for already registered name,
+    // window options of first registration apply.
+    StatHandle register_stat(
+        const std::string& stat_name,
+        const StatisticWindowOptions& window_options = {}
+    );
+    void push_value(const StatHandle stat, const double value);
+    // Registers stat on every call, prefer handles for frequent pushes
     void push_value(const std::string& stat_name, const double value);
+    void flush();
+    void reset_window(const StatHandle stat);
     std::vector<std::pair<std::string, StatisticAnalysis>> get_analysis_all();
     std::vector<std::pair<std::string, double>> get_last_all();
 
   private:
-    std::unordered_map<std::string, FrameStatisticTracker> _trackers;
+    struct _ThreadBuffer {
+        std::thread::id thread_id;
+        std::unique_ptr<SpscRingBuffer> samples;
+    };
+
+    const uint64_t _id;
+    std::unordered_map<std::string, StatHandle> _handles;
+    // indexed by handle
+    std::deque<std::pair<std::string, FrameStatisticTracker>> _trackers;
+    // buffers of exited threads are kept, recycled thread id reuses them
+    std::vector<_ThreadBuffer> _thread_buffers;
     std::mutex _mutex;
+
+    SpscRingBuffer& _get_thread_buffer();
+    void _merge_buffer(SpscRingBuffer& buffer);
 };
 
 class StatAutoPusher {
   protected:
+    StatAutoPusher(const StatHandle stat);
     StatAutoPusher(const std::string& stat_name);
     ~StatAutoPusher() = default;
     StatAutoPusher(const StatAutoPusher&) = delete;
@@ -62,11 +169,12 @@ class StatAutoPusher {
     StatAutoPusher& operator=(const StatAutoPusher&) = delete;
     StatAutoPusher& operator=(StatAutoPusher&&) = default;
 
-    std::string _stat_name;
+    StatHandle _stat;
 };
 
 class CounterStatAutoPusher : public StatAutoPusher {
   public:
+    CounterStatAutoPusher(const StatHandle stat);
     CounterStatAutoPusher(const std::string& stat_name);
     ~CounterStatAutoPusher();
 
@@ -81,6 +189,7 @@ class StopwatchStatAutoPusher : public StatAutoPusher {
     using StopwatchUnit = std::chrono::duration<double>;
 
   public:
+    StopwatchStatAutoPusher(const StatHandle stat);
     StopwatchStatAutoPusher(const std::string& stat_name);
     ~StopwatchStatAutoPusher();
 
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <cstring>
+#include <exception>
+#include <future>
+#include <list>
 #include <memory>
 #include <string>
 #include <vector>
@@ -18,6 +21,35 @@ void
 initialize_textures();
 void
 uninitialize_textures();
+// Finishes asynchronous image loads whose decoding is done,
+// called by engine once per frame.
+void
+process_pending_textures();
+
+struct TexturesResidencyStats {
+    size_t memory_budget;
+    size_t resident_bytes;
+    size_t resident_count;
+    uint64_t evictions;
+    uint64_t reloads;
+    // RAM taken by images kept by textures (including ones waiting
+    // for GPU upload)
+    size_t cpu_image_bytes;
+};
+
+// When image textures take more GPU memory than the budget, least
+// recently drawn ones are evicted and reloaded from their files
+// (or mounted archives) when drawn again. Zero disables the limit.
+void
+set_textures_memory_budget(const size_t budget);
+size_t
+get_textures_memory_budget();
+TexturesResidencyStats
+get_textures_residency_stats();
+// Evicts textures exceeding the budget, called by engine after
+// every frame.
+void
+update_textures_residency();
 
 bimg::ImageContainer*
 load_image(const uint8_t* data, size_t size);
@@ -28,15 +60,62 @@ load_raw_image(
     bimg::TextureFormat::Enum format, uint16_t width, uint16_t height,
     const std::vector<uint8_t>& data
 );
+bimg::ImageContainer*
+load_raw_image(
+    bimg::TextureFormat::Enum format, uint16_t width, uint16_t height,
+    const uint8_t* data
+);
 
+// Returns RGBA8 image with full mip chain, built with box filter
+// weighted by alpha (so transparent texels don't darken edges).
+// Rows are processed on worker pool.
+bimg::ImageContainer*
+generate_image_mips(const bimg::ImageContainer* image);
+// Converts whole image (including mips) to given uncompressed
+// format, block-compressed source is decoded.
+bimg::ImageContainer*
+convert_image(
+    const bimg::ImageContainer* image, const bimg::TextureFormat::Enum format
+);
+// Requires initialized engine (queries renderer capabilities).
+bool
+is_texture_format_supported(const bimg::TextureFormat::Enum format);
+
+bool
+can_query_image(const bimg::ImageContainer* image);
 glm::dvec4
 query_image_pixel(const bimg::ImageContainer* image, const glm::uvec2 position);
 
 class FontData;
 
+enum struct ImageRetention {
+    // whole image is kept, all its pixels can be queried
+    full,
+    // half resolution RGBA8 copy is kept for approximate queries
+    downsampled,
+    // only alpha channel is kept, enough for hit-testing
+    alpha,
+    // image is freed once GPU upload completes, texture can't be queried
+    none,
+};
+
+struct TextureOptions {
+    // Generate mip chain for images without one, so downscaled
+    // sprites don't alias.
+    bool generate_mips = false;
+    // BGFX_SAMPLER_* flags used when texture is sampled without
+    // explicit ones (e.g. by sprites).
+    uint64_t sampler_flags = BGFX_SAMPLER_NONE;
+    // What stays in RAM after image is uploaded to GPU
+    ImageRetention image_retention = ImageRetention::full;
+};
+
 class Texture : public Resource {
   public:
     bgfx::TextureHandle handle() const;
+    // Handle for binding texture to draw call, lets texture
+    // track its usage.
+    bgfx::TextureHandle bind_handle();
     virtual glm::uvec2 get_dimensions() const = 0;
     virtual bool can_query() const;
     virtual glm::dvec4 query_pixel(const glm::uvec2 position) const;
@@ -44,6 +123,8 @@ class Texture : public Resource {
   protected:
     bgfx::TextureHandle _handle;
 
+    virtual void _on_bind();
+
     friend class FontData;
 };
 
@@ -51,34 +132,123 @@ class MemoryTexture : public Texture {
   public:
     MemoryTexture() = default;
     ~MemoryTexture();
+    // Released after GPU upload unless image retention is full
     std::shared_ptr<bimg::ImageContainer> image_container;
 
     bool can_query() const override;
     glm::dvec4 query_pixel(const glm::uvec2 position) const override;
     glm::uvec2 get_dimensions() const override;
     static ResourceReference<MemoryTexture> create(
-        bimg::ImageContainer* image_container
+        bimg::ImageContainer* image_container,
+        const TextureOptions& options = {}
     );
 
   protected:
-    MemoryTexture(bimg::ImageContainer* image_container);
+    uint64_t _sampler_flags = BGFX_SAMPLER_NONE;
+    ImageRetention _image_retention = ImageRetention::full;
+    glm::uvec2 _dimensions = {1, 1};
+    size_t _uploaded_bytes = 0;
+    // image (or its retained copy) used by query_pixel
+    std::shared_ptr<bimg::ImageContainer> _query_image_container;
+
+    MemoryTexture(
+        bimg::ImageContainer* image_container,
+        const TextureOptions& options = {}
+    );
+    // Takes ownership of given image
+    void _set_image_container(bimg::ImageContainer* image_container);
     virtual void _initialize() override;
     virtual void _uninitialize() override;
 
     friend std::unique_ptr<MemoryTexture> load_default_texture();
 };
 
+// Texture which keeps CPU-side copy of its content, so its regions
+// can be updated after creation (used by glyph atlases).
+class UpdatableTexture : public Texture {
+  public:
+    ~UpdatableTexture();
+
+    bool can_query() const override;
+    glm::dvec4 query_pixel(const glm::uvec2 position) const override;
+    glm::uvec2 get_dimensions() const override;
+    // `data` holds tightly packed pixels of updated region
+    void update(
+        const glm::uvec2 position, const glm::uvec2 size, const uint8_t* data
+    );
+    static ResourceReference<UpdatableTexture> create(
+        bimg::ImageContainer* image_container
+    );
+
+  protected:
+    std::shared_ptr<bimg::ImageContainer> _image_container;
+
+    UpdatableTexture(bimg::ImageContainer* image_container);
+    virtual void _initialize() override;
+    virtual void _uninitialize() override;
+};
+
 class ImageTexture : public MemoryTexture {
   public:
     const std::string path;
 
-    static ResourceReference<ImageTexture> load(const std::string& path);
+    ~ImageTexture();
+
+    bool can_query() const override;
+    glm::dvec4 query_pixel(const glm::uvec2 position) const override;
+    // Evicted textures stay loaded, their images retained in RAM
+    // can still be queried.
+    bool is_loaded() const;
+    // Whether texture is uploaded to GPU, textures are evicted from
+    // it when textures memory budget is exceeded. Drawing evicted
+    // texture uploads its retained image again, if image retention
+    // is not full it's decoded from file instead and texture is drawn
+    // as 1x1 white placeholder until that completes.
+    bool is_resident() const;
+    // Blocks until image is decoded and creates its GPU texture,
+    // rethrows decoding error (also when loading failed earlier).
+    // Must be called from engine thread.
+    void wait_until_loaded();
+
+    // Textures are shared per path, options of first load apply.
+    // Throws if image of already registered texture failed to load.
+    static ResourceReference<ImageTexture> load(
+        const std::string& path, const TextureOptions& options = {}
+    );
+    // Returns immediately, image is decoded (and its mips generated)
+    // on worker pool and uploaded to GPU on engine thread once ready.
+    // Until then texture is drawn as 1x1 white placeholder, sprites
+    // capture texture dimensions so they should be created after
+    // loading completes.
+    static ResourceReference<ImageTexture> load_async(
+        const std::string& path, const TextureOptions& options = {}
+    );
 
   private:
-    ImageTexture(const std::string& path);
+    TextureOptions _options;
+    std::future<bimg::ImageContainer*> _pending_image;
+    std::exception_ptr _load_error;
+    bool _loaded = false;
+    bool _evicted = false;
+    bool _resident = false;
+    uint64_t _last_bind_frame = 0;
+    std::list<ImageTexture*>::iterator _residency_position;
+
+    ImageTexture(
+        const std::string& path, const TextureOptions& options,
+        const bool asynchronous
+    );
+    void _start_loading();
+    void _reload();
+    void _finish_loading();
+    void _evict();
+    void _on_bind() override;
     virtual void _initialize() override;
+    virtual void _uninitialize() override;
 
     friend class ResourcesRegistry<std::string, ImageTexture>;
+    friend void process_pending_textures();
+    friend void update_textures_residency();
 };
 
 template<typename T = uint8_t>
@@ -1,11 +1,17 @@
 #include <exception>
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <functional>
 #include <future>
 #include <initializer_list>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
 #include "kaacore/log.h"
@@ -110,4 +116,77 @@ class AwaitableStateEnum {
     std::mutex _mutex;
 };
 
+// Fixed-size pool of worker threads for CPU-bound work.
+class ThreadPool {
+  public:
+    ThreadPool(const size_t threads_count);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t threads_count() const;
+
+    template<typename Func>
+    std::future<std::invoke_result_t<Func>> submit(Func&& func)
+    {
+        using T = std::invoke_result_t<Func>;
+        // std::function requires copyable callable
+        auto task = std::make_shared<std::packaged_task<T()>>(
+            std::forward<Func>(func)
+        );
+        auto result_future = task->get_future();
+        {
+            std::lock_guard lock{this->_tasks_mutex};
+            this->_tasks.emplace_back([task]() { (*task)(); });
+        }
+        this->_tasks_condition.notify_one();
+        return result_future;
+    }
+
+    // Calls func(i) for every i in [0, count) and blocks until all calls
+    // are done. Calling thread takes part in the work, so it's safe
+    // to use from within pool's tasks. First thrown exception is rethrown.
+    void parallel_for(
+        const size_t count, const std::function<void(size_t)>& func
+    );
+
+  private:
+    std::vector<std::thread> _threads;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _tasks_mutex;
+    std::condition_variable _tasks_condition;
+    bool _stopping = false;
+
+    void _worker_loop();
+};
+
+// Process-wide pool, sized to hardware concurrency
+// (minus calling thread), created on first use.
+ThreadPool&
+get_worker_pool();
+
+// Lock-free byte queue for exactly one producer and one consumer
+// thread, e.g. feeding audio callback with decoded samples.
+class SpscRingBuffer {
+  public:
+    SpscRingBuffer(const size_t capacity);
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    size_t capacity() const;
+    // Producer side, returns number of bytes written.
+    size_t free_space() const;
+    size_t write(const std::byte* data, const size_t size);
+    // Consumer side, returns number of bytes read.
+    size_t available() const;
+    size_t read(std::byte* data, const size_t size);
+
+  private:
+    std::vector<std::byte> _buffer;
+    // total numbers of bytes written and read, wrapped by capacity
+    // when indexing
+    std::atomic<size_t> _write_position = 0;
+    std::atomic<size_t> _read_position = 0;
+};
+
 } // namespace kaacore
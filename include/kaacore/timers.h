@@ -4,7 +4,7 @@
 #include <chrono>
 #include <functional>
 #include <memory>
-#include <mutex>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -26,7 +26,8 @@ using TimerCallback = std::function<Duration(TimerContext context)>;
 struct _TimerState {
     _TimerState(TimerId id, TimerCallback&& callback);
 
-    TimerId id;
+    // written by thread starting the timer, read by the processing thread
+    std::atomic<TimerId> id;
     TimerCallback callback;
     std::atomic<bool> is_running;
 };
@@ -53,45 +54,56 @@ class TimersManager {
   public:
     TimersManager();
     TimersManager(Scene* const scene);
+    ~TimersManager();
+    TimersManager(const TimersManager&) = delete;
+    TimersManager& operator=(const TimersManager&) = delete;
+
+    // Safe to call from any thread, never blocks.
     void start(const Duration interval, Timer& timer);
     void process(const HighPrecisionDuration dt);
     TimePoint time_point() const;
 
   private:
-    using _AwaitingState =
-        std::tuple<TimerId, Duration, std::weak_ptr<_TimerState>>;
+    // node of intrusive lock-free stack (multiple producers, single consumer)
+    struct _AwaitingState {
+        TimerId invocation_id;
+        Duration interval;
+        std::weak_ptr<_TimerState> state;
+        _AwaitingState* next;
+    };
 
     struct _InvocationInstance {
         _InvocationInstance(
             TimerId invocation_id, Duration interval, TimePoint triggered_at,
-            std::weak_ptr<_TimerState>&& state
+            uint64_t sequence, std::weak_ptr<_TimerState>&& state
         );
 
         TimerId invocation_id;
         Duration interval;
-        TimePoint triggered_at;
+        TimePoint fire_at;
+        // keeps invocations firing at the same time in scheduling order
+        uint64_t sequence;
         std::weak_ptr<_TimerState> state;
 
-        inline TimePoint fire_at() const
+        void reschedule(
+            const Duration interval, const TimePoint triggered_at,
+            const uint64_t sequence
+        );
+        // ordering for std heap algorithms, earliest invocation on top
+        inline bool operator<(const _InvocationInstance& other) const
         {
-            return this->triggered_at +
-                   std::chrono::duration_cast<HighPrecisionDuration>(
-                       this->interval
-                   );
+            return std::tie(this->fire_at, this->sequence) >
+                   std::tie(other.fire_at, other.sequence);
         }
     };
 
-    std::mutex _lock;
     Scene* const _scene;
-    HighPrecisionDuration _dt_accumulator;
-    struct {
-        bool is_dirty = false;
-        std::vector<_InvocationInstance> data;
-    } _queue;
-    struct {
-        std::atomic<bool> is_dirty = false;
-        std::vector<_AwaitingState> data;
-    } _awaiting_timers;
+    HighPrecisionDuration _dt_accumulator = 0us;
+    uint64_t _sequence_counter = 0;
+    // binary min-heap of invocations
+    std::vector<_InvocationInstance> _queue;
+    std::vector<_InvocationInstance> _rescheduled;
+    std::atomic<_AwaitingState*> _awaiting_timers = nullptr;
 
     static inline std::atomic<TimerId> _last_id = 0;
 };
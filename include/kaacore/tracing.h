@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "kaacore/config.h"
+
+namespace kaacore {
+
+// Events kept by each thread, older ones are overwritten
+constexpr size_t trace_thread_buffer_size = 16384u;
+static const char* trace_output_env_name = "KAACORE_TRACE_OUTPUT";
+
+#if KAACORE_TRACING
+
+enum struct TraceEventPhase : char {
+    begin = 'B',
+    end = 'E',
+};
+
+struct TraceEvent {
+    // string literals, only pointers are recorded
+    const char* category;
+    const char* name;
+    const char* arg_name;
+    double arg_value;
+    int64_t timestamp;
+    TraceEventPhase phase;
+};
+
+void
+trace_event(
+    const TraceEventPhase phase, const char* category, const char* name,
+    const char* arg_name = nullptr, const double arg_value = 0.
+);
+void
+set_trace_thread_name(const std::string& name);
+
+class TraceScope {
+  public:
+    TraceScope(
+        const char* category, const char* name,
+        const char* arg_name = nullptr, const double arg_value = 0.
+    );
+    ~TraceScope();
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+  private:
+    const char* _category;
+    const char* _name;
+};
+
+#define _KAACORE_TRACE_CONCAT_IMPL(a, b) a##b
+#define _KAACORE_TRACE_CONCAT(a, b) _KAACORE_TRACE_CONCAT_IMPL(a, b)
+#define KAACORE_TRACE_SCOPE(category, name)                                    \
+    ::kaacore::TraceScope _KAACORE_TRACE_CONCAT(_trace_scope_, __LINE__)(      \
+        category, name                                                         \
+    )
+#define KAACORE_TRACE_SCOPE_ARG(category, name, arg_name, arg_value)           \
+    ::kaacore::TraceScope _KAACORE_TRACE_CONCAT(_trace_scope_, __LINE__)(      \
+        category, name, arg_name, double(arg_value)                            \
+    )
+#define KAACORE_TRACE_THREAD_NAME(name) ::kaacore::set_trace_thread_name(name)
+
+#else
+
+#define KAACORE_TRACE_SCOPE(category, name)
+#define KAACORE_TRACE_SCOPE_ARG(category, name, arg_name, arg_value)
+#define KAACORE_TRACE_THREAD_NAME(name)
+
+#endif
+
+// Recorded events in Chrome trace JSON format (can be opened in
+// Perfetto UI or chrome://tracing). Without KAACORE_TRACING
+// the trace is always empty.
+std::string
+dump_trace_json();
+bool
+write_trace(const std::string& path);
+void
+clear_trace();
+
+} // namespace kaacore
@@ -3,12 +3,14 @@
 #include <cmath>
 #include <functional>
 #include <memory>
-#include <unordered_map>
+#include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include <glm/glm.hpp>
 
+#include "kaacore/batched_transitions.h"
 #include "kaacore/clock.h"
 #include "kaacore/easings.h"
 #include "kaacore/node_ptr.h"
@@ -17,6 +19,16 @@ namespace kaacore {
 
 const std::string default_transition_name = "__default__";
 
+// Transition names are interned into integer slots, which are used to
+// key transitions of a node. Slots are valid for the whole process lifetime.
+typedef uint32_t NodeTransitionSlot;
+constexpr NodeTransitionSlot default_transition_slot = 0;
+
+NodeTransitionSlot
+get_transition_slot(const std::string& name);
+const std::string&
+get_transition_slot_name(const NodeTransitionSlot slot);
+
 class NodeTransitionBase;
 typedef std::shared_ptr<const NodeTransitionBase> NodeTransitionHandle;
 
@@ -60,6 +72,11 @@ class NodeTransitionBase {
     virtual void process_time_point(
         TransitionStateBase* state, NodePtr node, const TransitionTimePoint& tp
     ) const = 0;
+    // Transitions that can be expressed as plain interpolation of
+    // node attribute return their parameters here, so they can be
+    // evaluated in bulk by scene's BatchedTransitionsManager.
+    virtual std::optional<BatchedTransitionParams> batched_params(NodePtr node
+    ) const;
 };
 
 class NodeTransitionCustomizable : public NodeTransitionBase {
@@ -154,8 +171,13 @@ struct NodeTransitionRunner {
     bool transition_state_prepared = false;
     HighPrecisionDuration current_time = 0us;
 
+    BatchedTransitionsManager* _batch_manager = nullptr;
+    BatchedTransitionAttribute _batch_attribute =
+        BatchedTransitionAttribute::none;
+    uint32_t _batch_index = 0;
+
     NodeTransitionRunner(const NodeTransitionHandle& transition);
-    ~NodeTransitionRunner() = default;
+    ~NodeTransitionRunner();
     NodeTransitionRunner(const NodeTransitionRunner&) = delete;
     NodeTransitionRunner(NodeTransitionRunner&&) = delete;
 
@@ -166,20 +188,45 @@ struct NodeTransitionRunner {
 
     void setup(const NodeTransitionHandle& transition);
     bool step(NodePtr node, const HighPrecisionDuration dt);
+    bool is_batched() const;
+    HighPrecisionDuration elapsed_time() const;
+    void elapsed_time(const HighPrecisionDuration elapsed_time);
     operator bool() const;
+
+  private:
+    void _unbatch();
 };
 
 class NodeTransitionsManager {
     friend class Scene;
-
-    std::unordered_map<std::string, NodeTransitionRunner> _transitions_map;
-    std::vector<std::pair<std::string, NodeTransitionHandle>> _enqueued_updates;
+    friend class SimulationSnapshot;
+    friend class BatchedTransitionsManager;
+
+    // runners are heap allocated since their addresses must be stable
+    using _RunnersVector = std::vector<
+        std::pair<NodeTransitionSlot, std::unique_ptr<NodeTransitionRunner>>>;
+
+    // must outlive runners, they update it when being unbatched
+    uint32_t _batched_runners_count = 0;
+    _RunnersVector _runners;
+    std::vector<std::pair<NodeTransitionSlot, NodeTransitionHandle>>
+        _enqueued_updates;
     bool _is_processing = false;
 
     void step(NodePtr node, const HighPrecisionDuration dt);
+    _RunnersVector::iterator _find_runner(const NodeTransitionSlot slot);
+    void _apply_update(
+        const NodeTransitionSlot slot, const NodeTransitionHandle& transition
+    );
+    void _remove_runner(const NodeTransitionRunner* runner);
+    bool _requires_stepping() const;
 
   public:
+    NodeTransitionHandle get(const NodeTransitionSlot slot);
     NodeTransitionHandle get(const std::string& name);
+    void set(
+        const NodeTransitionSlot slot, const NodeTransitionHandle& transition
+    );
     void set(const std::string& name, const NodeTransitionHandle& transition);
     operator bool() const;
 };
@@ -96,9 +96,7 @@ class Sampler : public UniformBase {
     uint32_t _flags;
 
     bgfx::TextureHandle _texture_handle();
-    void _set(
-        const Texture* texture, const uint8_t stage, const uint32_t flags
-    );
+    void _set(Texture* texture, const uint8_t stage, const uint32_t flags);
     void _bind();
 
     friend class ShadingContext;
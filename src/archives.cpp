@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "kaacore/compression.h"
+#include "kaacore/exceptions.h"
+#include "kaacore/log.h"
+
+#include "kaacore/archives.h"
+
+namespace kaacore {
+
+constexpr uint32_t archive_magic = 0x4B41504B; // "KPAK"
+constexpr uint16_t archive_version = 1;
+
+enum class _ArchiveCompression : uint8_t {
+    none = 0,
+    lz4 = 1,
+};
+
+struct _ArchiveHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entry_size;
+    uint32_t entries_count;
+    uint32_t names_size;
+};
+
+static_assert(std::is_trivially_copyable_v<_ArchiveHeader>);
+static_assert(std::is_trivially_copyable_v<_ArchiveEntry>);
+
+struct _MountedArchive {
+    std::string mount_point;
+    std::shared_ptr<Archive> archive;
+};
+
+// replaced on every (un)mount, so readers only need to grab pointer
+std::mutex _mounted_archives_lock;
+std::shared_ptr<const std::vector<_MountedArchive>> _mounted_archives;
+
+std::string
+_normalize_archive_name(const std::string_view name)
+{
+    std::string normalized{name};
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    size_t prefix_length = 0;
+    while (true) {
+        if (normalized.compare(prefix_length, 2, "./") == 0) {
+            prefix_length += 2;
+        } else if (normalized.compare(prefix_length, 1, "/") == 0) {
+            prefix_length += 1;
+        } else {
+            break;
+        }
+    }
+    normalized.erase(0, prefix_length);
+    while (not normalized.empty() and normalized.back() == '/') {
+        normalized.pop_back();
+    }
+    return normalized;
+}
+
+inline size_t
+_align_size(const size_t size)
+{
+    return (size + archive_alignment - 1) / archive_alignment *
+           archive_alignment;
+}
+
+Archive::Archive(const std::string& path) noexcept(false)
+    : path(path), _mapped_file(std::make_shared<MappedFile>(path))
+{
+    const auto invalid_archive_error = [&path]() {
+        return kaacore::exception(
+            fmt::format("Invalid archive file: {}", path)
+        );
+    };
+    const std::byte* data = this->_mapped_file->data();
+    const size_t size = this->_mapped_file->size();
+
+    _ArchiveHeader header;
+    if (size < sizeof(header)) {
+        throw invalid_archive_error();
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != archive_magic or header.version != archive_version or
+        header.entry_size != sizeof(_ArchiveEntry)) {
+        throw invalid_archive_error();
+    }
+    const size_t index_size = header.entries_count * sizeof(_ArchiveEntry);
+    if (size - sizeof(header) < index_size + header.names_size) {
+        throw invalid_archive_error();
+    }
+    this->_entries.resize(header.entries_count);
+    std::memcpy(this->_entries.data(), data + sizeof(header), index_size);
+    this->_names =
+        reinterpret_cast<const char*>(data + sizeof(header) + index_size);
+
+    std::string_view previous_name;
+    for (const auto& entry : this->_entries) {
+        if (entry.name_offset > header.names_size or
+            entry.name_length > header.names_size - entry.name_offset or
+            entry.data_offset > size or
+            entry.stored_size > size - entry.data_offset) {
+            throw invalid_archive_error();
+        }
+        const auto compression = _ArchiveCompression(entry.compression);
+        if (compression != _ArchiveCompression::none and
+            compression != _ArchiveCompression::lz4) {
+            throw invalid_archive_error();
+        }
+        if (compression == _ArchiveCompression::none and
+            entry.stored_size != entry.size) {
+            throw invalid_archive_error();
+        }
+        // lookups depend on index being sorted
+        const auto name = this->_entry_name(entry);
+        if (&entry != &this->_entries.front() and name <= previous_name) {
+            throw invalid_archive_error();
+        }
+        previous_name = name;
+    }
+}
+
+size_t
+Archive::files_count() const
+{
+    return this->_entries.size();
+}
+
+bool
+Archive::contains(const std::string_view name) const
+{
+    return this->_find(name) != nullptr;
+}
+
+std::optional<Memory>
+Archive::read(const std::string_view name) const
+{
+    const auto entry = this->_find(name);
+    if (not entry) {
+        return std::nullopt;
+    }
+    auto stored_data = const_cast<std::byte*>(
+        this->_mapped_file->data() + entry->data_offset
+    );
+    if (_ArchiveCompression(entry->compression) == _ArchiveCompression::none) {
+        return Memory::share(
+            std::shared_ptr<std::byte>(this->_mapped_file, stored_data),
+            entry->size
+        );
+    }
+
+    auto decompressed = std::shared_ptr<std::byte>(
+        new std::byte[entry->size], std::default_delete<std::byte[]>()
+    );
+    if (not lz4_decompress(
+            stored_data, entry->stored_size, decompressed.get(), entry->size
+        )) {
+        throw kaacore::exception(fmt::format(
+            "Corrupted file {} in archive: {}", name, this->path
+        ));
+    }
+    return Memory::share(std::move(decompressed), entry->size);
+}
+
+std::string_view
+Archive::_entry_name(const _ArchiveEntry& entry) const
+{
+    return {this->_names + entry.name_offset, entry.name_length};
+}
+
+const _ArchiveEntry*
+Archive::_find(const std::string_view name) const
+{
+    auto it = std::lower_bound(
+        this->_entries.begin(), this->_entries.end(), name,
+        [this](const _ArchiveEntry& entry, const std::string_view name) {
+            return this->_entry_name(entry) < name;
+        }
+    );
+    if (it == this->_entries.end() or this->_entry_name(*it) != name) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+bool
+write_archive(
+    const std::string& path, const std::vector<ArchiveInput>& inputs,
+    const bool compress
+) noexcept(false)
+{
+    std::vector<std::pair<std::string, const ArchiveInput*>> sorted_inputs;
+    sorted_inputs.reserve(inputs.size());
+    for (const auto& input : inputs) {
+        sorted_inputs.emplace_back(_normalize_archive_name(input.name), &input);
+    }
+    std::sort(
+        sorted_inputs.begin(), sorted_inputs.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; }
+    );
+
+    _ArchiveHeader header{};
+    header.magic = archive_magic;
+    header.version = archive_version;
+    header.entry_size = sizeof(_ArchiveEntry);
+    header.entries_count = sorted_inputs.size();
+    std::vector<_ArchiveEntry> entries(sorted_inputs.size());
+    std::string names;
+    for (size_t i = 0; i < sorted_inputs.size(); i++) {
+        const auto& name = sorted_inputs[i].first;
+        if (i > 0 and name == sorted_inputs[i - 1].first) {
+            throw kaacore::exception(
+                fmt::format("Duplicated file name in archive: {}", name)
+            );
+        }
+        if (name.empty() or name.size() > UINT16_MAX) {
+            throw kaacore::exception(
+                fmt::format("Invalid file name in archive: {}", name)
+            );
+        }
+        entries[i].name_offset = names.size();
+        entries[i].name_length = name.size();
+        names += name;
+    }
+    header.names_size = names.size();
+
+    const size_t index_size = entries.size() * sizeof(_ArchiveEntry);
+    std::vector<std::byte> buffer(
+        _align_size(sizeof(header) + index_size + names.size())
+    );
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(
+        buffer.data() + sizeof(header) + index_size, names.data(), names.size()
+    );
+
+    for (size_t i = 0; i < sorted_inputs.size(); i++) {
+        MappedFile file{sorted_inputs[i].second->source_path};
+        auto& entry = entries[i];
+        entry.data_offset = buffer.size();
+        entry.size = file.size();
+        entry.stored_size = file.size();
+        entry.compression = uint8_t(_ArchiveCompression::none);
+        std::vector<std::byte> compressed;
+        if (compress and file.size() > 0) {
+            compressed = lz4_compress(file.data(), file.size());
+        }
+        if (not compressed.empty() and compressed.size() < file.size()) {
+            entry.stored_size = compressed.size();
+            entry.compression = uint8_t(_ArchiveCompression::lz4);
+            buffer.insert(buffer.end(), compressed.begin(), compressed.end());
+        } else {
+            buffer.insert(
+                buffer.end(), file.data(), file.data() + file.size()
+            );
+        }
+        buffer.resize(_align_size(buffer.size()));
+    }
+    std::memcpy(buffer.data() + sizeof(header), entries.data(), index_size);
+
+    KAACORE_LOG_INFO(
+        "Writing archive: {} ({} files, {} bytes)", path, entries.size(),
+        buffer.size()
+    );
+    return write_file(path, buffer.data(), buffer.size());
+}
+
+void
+mount_archive(
+    const std::string& archive_path, const std::string& mount_point
+) noexcept(false)
+{
+    auto archive = std::make_shared<Archive>(archive_path);
+    KAACORE_LOG_INFO(
+        "Mounted archive: {} ({} files) at: '{}'", archive_path,
+        archive->files_count(), mount_point
+    );
+    std::lock_guard lock{_mounted_archives_lock};
+    auto mounted_archives = std::make_shared<std::vector<_MountedArchive>>();
+    if (_mounted_archives) {
+        *mounted_archives = *_mounted_archives;
+    }
+    mounted_archives->push_back(
+        {_normalize_archive_name(mount_point), std::move(archive)}
+    );
+    _mounted_archives = std::move(mounted_archives);
+}
+
+void
+unmount_archive(const std::string& archive_path)
+{
+    std::lock_guard lock{_mounted_archives_lock};
+    if (not _mounted_archives) {
+        return;
+    }
+    auto mounted_archives = std::make_shared<std::vector<_MountedArchive>>();
+    for (const auto& mounted : *_mounted_archives) {
+        if (mounted.archive->path != archive_path) {
+            mounted_archives->push_back(mounted);
+        }
+    }
+    if (mounted_archives->empty()) {
+        mounted_archives.reset();
+    }
+    _mounted_archives = std::move(mounted_archives);
+}
+
+std::optional<Memory>
+read_mounted_file(const std::string& path)
+{
+    std::shared_ptr<const std::vector<_MountedArchive>> mounted_archives;
+    {
+        // archives are read without holding the lock,
+        // so decompression doesn't block other threads
+        std::lock_guard lock{_mounted_archives_lock};
+        if (not _mounted_archives) {
+            return std::nullopt;
+        }
+        mounted_archives = _mounted_archives;
+    }
+
+    const auto name = _normalize_archive_name(path);
+    for (auto it = mounted_archives->rbegin(); it != mounted_archives->rend();
+         it++) {
+        std::string_view relative_name = name;
+        const auto& mount_point = it->mount_point;
+        if (not mount_point.empty()) {
+            if (relative_name.size() <= mount_point.size() or
+                relative_name.substr(0, mount_point.size()) != mount_point or
+                relative_name[mount_point.size()] != '/') {
+                continue;
+            }
+            relative_name.remove_prefix(mount_point.size() + 1);
+        }
+        if (auto memory = it->archive->read(relative_name)) {
+            return memory;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace kaacore
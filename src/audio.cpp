@@ -1,24 +1,37 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <ios>
 #include <string>
 
 #include "SDL_mixer.h"
 
 #include "kaacore/engine.h"
 #include "kaacore/exceptions.h"
+#include "kaacore/files.h"
 #include "kaacore/input.h"
 #include "kaacore/log.h"
+#include "kaacore/statistics.h"
+#include "kaacore/threading.h"
 
 #include "kaacore/audio.h"
 
 namespace kaacore {
 
 const uint16_t default_mixing_channels_count = 32;
+const size_t stream_carrier_chunk_size = 4096;
+const size_t stream_decode_chunk_size = 16 * 1024;
+const auto streaming_interval = std::chrono::milliseconds(10);
 ResourcesRegistry<std::string, SoundData> _sound_registry;
+ResourcesRegistry<std::string, SoundData> _streaming_sound_registry;
 ResourcesRegistry<std::string, MusicData> _music_registry;
 
 void
 initialize_audio()
 {
     _sound_registry.initialze();
+    _streaming_sound_registry.initialze();
     _music_registry.initialze();
 }
 
@@ -26,10 +39,86 @@ void
 uninitialize_audio()
 {
     _sound_registry.uninitialze();
+    _streaming_sound_registry.uninitialze();
     _music_registry.uninitialze();
 }
 
-SoundData::SoundData(const std::string& path) : path(path)
+// Single streamed playback, decoder is driven by streaming thread
+// and buffer is drained by channel effect on audio thread.
+struct _SoundStream {
+    std::unique_ptr<WavStreamDecoder> decoder;
+    SpscRingBuffer buffer;
+    std::vector<std::byte> decoded_chunk;
+    ChannelId channel_id = 0;
+    // set by streaming thread once last samples are buffered
+    std::atomic<bool> decoded = false;
+    std::atomic<bool> finish_requested = false;
+    // set when channel stops, stream is no longer used by mixer then
+    std::atomic<bool> detached = false;
+
+    _SoundStream(
+        std::unique_ptr<WavStreamDecoder> decoder, const size_t buffer_size
+    )
+        : decoder(std::move(decoder)), buffer(buffer_size),
+          decoded_chunk(std::min(buffer_size, stream_decode_chunk_size))
+    {
+        if (this->decoded_chunk.size() < this->decoder->frame_size()) {
+            throw kaacore::exception("Sound stream buffer is too small.");
+        }
+    }
+
+    void fill()
+    {
+        while (not this->decoded) {
+            const size_t size =
+                std::min(this->buffer.free_space(), this->decoded_chunk.size());
+            if (size < this->decoder->frame_size()) {
+                return;
+            }
+            const size_t decoded_size =
+                this->decoder->decode(this->decoded_chunk.data(), size);
+            if (decoded_size == 0) {
+                this->decoded = true;
+                return;
+            }
+            this->buffer.write(this->decoded_chunk.data(), decoded_size);
+        }
+    }
+};
+
+void
+_stream_effect(int channel, void* stream, int length, void* udata)
+{
+    auto sound_stream = static_cast<_SoundStream*>(udata);
+    auto output = static_cast<std::byte*>(stream);
+    // checked before reading, so samples buffered in the meantime
+    // are not lost
+    const bool decoded = sound_stream->decoded;
+    const size_t read_size = sound_stream->buffer.read(output, length);
+    // buffer underrun or end of sound, the rest is silence
+    std::memset(output + read_size, 0, length - read_size);
+    if (decoded and read_size < size_t(length) and
+        not sound_stream->finish_requested.exchange(true)) {
+        // mixer can't be stopped from its own callback
+        SDL_Event event;
+        event.type = static_cast<uint32_t>(EventType::_sound_stream_finished);
+        event.user.code = channel;
+        SDL_PushEvent(&event);
+    }
+}
+
+void
+_stream_effect_done(int channel, void* udata)
+{
+    static_cast<_SoundStream*>(udata)->detached = true;
+}
+
+SoundData::SoundData(
+    const std::string& path, const bool streaming,
+    const size_t stream_buffer_size
+)
+    : path(path), streaming(streaming), stream_buffer_size(stream_buffer_size),
+      _raw_sound(nullptr)
 {
     if (is_engine_initialized()) {
         this->_initialize();
@@ -56,21 +145,35 @@ SoundData::load(const std::string& path)
     return sound_data;
 }
 
+ResourceReference<SoundData>
+SoundData::load_streaming(const std::string& path, const size_t buffer_size)
+{
+    std::shared_ptr<SoundData> sound_data;
+    if ((sound_data = _streaming_sound_registry.get_resource(path))) {
+        return sound_data;
+    }
+
+    sound_data =
+        std::shared_ptr<SoundData>(new SoundData(path, true, buffer_size));
+    _streaming_sound_registry.register_resource(path, sound_data);
+    return sound_data;
+}
+
 void
 SoundData::_initialize()
 {
-    this->_raw_sound =
-        get_engine()->audio_manager->load_raw_sound(this->path.c_str());
+    if (not this->streaming) {
+        this->_chunk = get_engine()->audio_manager->_load_sound(this->path);
+        this->_raw_sound = this->_chunk.get();
+    }
     this->is_initialized = true;
 }
 
 void
 SoundData::_uninitialize()
 {
-    if (this->_raw_sound) {
-        Mix_FreeChunk(this->_raw_sound);
-        this->_raw_sound = nullptr;
-    }
+    this->_chunk.reset();
+    this->_raw_sound = nullptr;
     this->is_initialized = false;
 }
 
@@ -86,6 +189,14 @@ Sound::load(const char* path, double volume)
     return Sound(SoundData::load(path), volume);
 }
 
+Sound
+Sound::load_streaming(
+    const char* path, double volume, const size_t buffer_size
+)
+{
+    return Sound(SoundData::load_streaming(path, buffer_size), volume);
+}
+
 double
 Sound::volume() const
 {
@@ -103,11 +214,35 @@ Sound::operator==(const Sound& other) const
     return this->_sound_data == other._sound_data;
 }
 
+uint16_t
+Sound::max_voices() const
+{
+    return this->_max_voices;
+}
+
+void
+Sound::max_voices(const uint16_t voices)
+{
+    this->_max_voices = voices;
+}
+
+int
+Sound::priority() const
+{
+    return this->_priority;
+}
+
+void
+Sound::priority(const int priority)
+{
+    this->_priority = priority;
+}
+
 void
 Sound::play(double volume_factor)
 {
     get_engine()->audio_manager->play_sound(
-        *this, this->_volume * volume_factor
+        *this, this->_volume * volume_factor, 1, true
     );
 }
 
@@ -204,6 +339,101 @@ SoundPlayback::stop()
     return false;
 }
 
+SoundBank::SoundBank(const std::vector<std::string>& paths)
+{
+    this->preload(paths);
+}
+
+SoundBank::~SoundBank()
+{
+    // decoding tasks use audio manager, their results are not needed
+    for (const auto& sound : this->_sounds) {
+        if (sound.pending_chunk.valid()) {
+            sound.pending_chunk.wait();
+        }
+    }
+}
+
+void
+SoundBank::preload(const std::vector<std::string>& paths)
+{
+    auto audio_manager = get_engine()->audio_manager.get();
+    for (const auto& path : paths) {
+        auto it = std::find_if(
+            this->_sounds.begin(), this->_sounds.end(),
+            [&path](const auto& sound) { return sound.path == path; }
+        );
+        if (it != this->_sounds.end()) {
+            continue;
+        }
+        auto pending_chunk = get_worker_pool().submit([audio_manager, path]() {
+            return audio_manager->_load_sound(path);
+        });
+        this->_sounds.push_back({path, std::move(pending_chunk), nullptr});
+    }
+}
+
+size_t
+SoundBank::size() const
+{
+    return this->_sounds.size();
+}
+
+size_t
+SoundBank::loaded_count() const
+{
+    return std::count_if(
+        this->_sounds.begin(), this->_sounds.end(),
+        [](const auto& sound) {
+            return not sound.pending_chunk.valid() or
+                   sound.pending_chunk.wait_for(std::chrono::seconds::zero()) ==
+                       std::future_status::ready;
+        }
+    );
+}
+
+double
+SoundBank::progress() const
+{
+    if (this->_sounds.empty()) {
+        return 1.;
+    }
+    return double(this->loaded_count()) / this->_sounds.size();
+}
+
+bool
+SoundBank::is_loaded() const
+{
+    return this->loaded_count() == this->_sounds.size();
+}
+
+void
+SoundBank::wait_until_loaded()
+{
+    for (auto& sound : this->_sounds) {
+        if (sound.pending_chunk.valid()) {
+            sound.chunk = sound.pending_chunk.get();
+        }
+    }
+}
+
+Sound
+SoundBank::get(const std::string& path, double volume)
+{
+    auto it = std::find_if(
+        this->_sounds.begin(), this->_sounds.end(),
+        [&path](const auto& sound) { return sound.path == path; }
+    );
+    if (it == this->_sounds.end()) {
+        throw kaacore::exception("Sound is not in the bank: " + path);
+    }
+    if (it->pending_chunk.valid()) {
+        it->chunk = it->pending_chunk.get();
+    }
+    // decoded sound is found in the cache
+    return Sound::load(path.c_str(), volume);
+}
+
 MusicData::MusicData(const std::string& path) : path(path)
 {
     if (is_engine_initialized()) {
@@ -375,7 +605,8 @@ _channel_finished_hook(int channel)
 }
 
 AudioManager::AudioManager()
-    : _master_volume(1.), _master_sound_volume(1.), _master_music_volume(1.)
+    : _master_volume(1.), _master_sound_volume(1.), _master_music_volume(1.),
+      _sound_cache(std::make_unique<SoundCache>())
 {
     KAACORE_LOG_INFO("Initializing audio.");
     KAACORE_CHECK(
@@ -399,10 +630,37 @@ AudioManager::AudioManager()
     Mix_ChannelFinished(_channel_finished_hook);
     this->_channels_state.resize(MIX_CHANNELS);
     this->mixing_channels(default_mixing_channels_count);
+
+    int mixer_channels;
+    Mix_QuerySpec(
+        &this->_mixer_frequency, &this->_mixer_format, &mixer_channels
+    );
+    this->_mixer_channels = mixer_channels;
+    this->_stream_carrier_samples.resize(stream_carrier_chunk_size, 0);
+    this->_stream_carrier_chunk = Mix_QuickLoad_RAW(
+        this->_stream_carrier_samples.data(),
+        this->_stream_carrier_samples.size()
+    );
+    this->_streaming_running = true;
+    this->_streaming_thread =
+        std::thread([this]() { this->_run_streaming(); });
 }
 
 AudioManager::~AudioManager()
 {
+    if (this->_streaming_thread.joinable()) {
+        {
+            std::lock_guard lock{this->_streams_lock};
+            this->_streaming_running = false;
+        }
+        this->_streams_condition.notify_one();
+        this->_streaming_thread.join();
+    }
+    if (this->_stream_carrier_chunk) {
+        // halts streamed playbacks
+        Mix_FreeChunk(this->_stream_carrier_chunk);
+    }
+    this->_sound_cache.reset();
     Mix_CloseAudio();
     Mix_Quit();
     Mix_HookMusicFinished(nullptr);
@@ -413,7 +671,25 @@ AudioManager::~AudioManager()
 Mix_Chunk*
 AudioManager::load_raw_sound(const char* path)
 {
-    auto raw_sound = Mix_LoadWAV(path);
+    // read through map_file, so sounds can be loaded from archives
+    Memory memory;
+    try {
+        memory = map_file(path);
+    } catch (const std::ios_base::failure& exc) {
+        KAACORE_LOG_ERROR(
+            "Failed to load sound from path {} ({})", path, exc.what()
+        );
+        return nullptr;
+    } catch (const kaacore::exception& exc) {
+        // e.g. corrupted archive entry
+        KAACORE_LOG_ERROR(
+            "Failed to load sound from path {} ({})", path, exc.what()
+        );
+        return nullptr;
+    }
+    auto raw_sound = Mix_LoadWAV_RW(
+        SDL_RWFromConstMem(memory.get(), memory.size()), 1
+    );
     if (not raw_sound) {
         KAACORE_LOG_ERROR(
             "Failed to load sound from path {} ({})", path, Mix_GetError()
@@ -422,6 +698,23 @@ AudioManager::load_raw_sound(const char* path)
     return raw_sound;
 }
 
+std::shared_ptr<Mix_Chunk>
+AudioManager::_load_sound(const std::string& path)
+{
+    if (auto chunk = this->_sound_cache->get(path)) {
+        KAACORE_LOG_DEBUG("Using cached sound: {}", path);
+        return chunk;
+    }
+    // cache is not locked while decoding, so sounds are decoded in parallel
+    auto raw_sound = this->load_raw_sound(path.c_str());
+    if (not raw_sound) {
+        return nullptr;
+    }
+    return this->_sound_cache->insert(
+        path, std::shared_ptr<Mix_Chunk>{raw_sound, Mix_FreeChunk}
+    );
+}
+
 Mix_Music*
 AudioManager::load_raw_music(const char* path)
 {
@@ -436,36 +729,250 @@ AudioManager::load_raw_music(const char* path)
 
 std::pair<ChannelId, PlaybackUid>
 AudioManager::play_sound(
-    const Sound& sound, const double volume_factor, const int loops
+    const Sound& sound, const double volume_factor, const int loops,
+    const bool deduplicate
 )
 {
     KAACORE_ASSERT(bool(sound), "Invalid sound data.");
-    if (sound._sound_data->_raw_sound) {
-        // SDL_mixer loops meaning are different, -1 is infinite, 0 is once, 1
-        // is twice, ...
-        auto mixer_loops = loops - 1;
-        auto channel =
-            Mix_PlayChannel(-1, sound._sound_data->_raw_sound, mixer_loops);
-        if (channel >= 0) {
-            KAACORE_ASSERT(
-                channel < this->_channels_state.size(), "Invalid channel id."
-            );
-            this->_channels_state[channel].current_sound = sound;
-            this->_channels_state[channel].requested_volume = volume_factor;
-            auto playback_uid = random_uid<PlaybackUid>();
-            this->_channels_state[channel].playback_uid = playback_uid;
-            this->_recalc_channel_volume(channel);
+    const SoundData* sound_data = sound._sound_data.get_valid();
+    if (not sound_data->_raw_sound and not sound_data->streaming) {
+        KAACORE_LOG_ERROR("Failed to played incorrectly loaded sound");
+        return {-1, 0};
+    }
+
+    if (deduplicate) {
+        for (const auto& [played_sound_data, channel] :
+             this->_frame_playbacks) {
+            if (played_sound_data != sound_data or
+                channel >= this->_channels_state.size()) {
+                continue;
+            }
+            auto& channel_state = this->_channels_state[channel];
+            // playback could be already stopped and its channel reused
+            if (channel_state.current_sound._sound_data.get() == sound_data) {
+                channel_state.requested_volume =
+                    std::max(channel_state.requested_volume, volume_factor);
+                this->_recalc_channel_volume(channel);
+                this->_voices_stats.deduplicated_voices++;
+                return {channel, channel_state.playback_uid};
+            }
+        }
+    }
+
+    int channel = -1;
+    if (sound._max_voices > 0) {
+        uint16_t voices = 0;
+        int oldest_channel = -1;
+        for (size_t i = 0; i < this->_channels_state.size(); i++) {
+            const auto& channel_state = this->_channels_state[i];
+            if (channel_state.current_sound._sound_data.get() != sound_data) {
+                continue;
+            }
+            voices++;
+            if (oldest_channel < 0 or
+                channel_state.start_order <
+                    this->_channels_state[oldest_channel].start_order) {
+                oldest_channel = i;
+            }
+        }
+        if (voices >= sound._max_voices) {
             KAACORE_LOG_DEBUG(
-                "Playing sound at channel {}, uid: {:#x}", channel, playback_uid
+                "Sound voices limit reached, stopping channel {}",
+                oldest_channel
             );
-            return {channel, playback_uid};
-        } else {
-            KAACORE_LOG_ERROR("Failed to play sound ({})", Mix_GetError());
+            this->_stop_channel(oldest_channel);
+            this->_voices_stats.stolen_voices++;
+            channel = oldest_channel;
         }
-    } else {
-        KAACORE_LOG_ERROR("Failed to played incorrectly loaded sound");
     }
-    return {-1, 0};
+    if (channel < 0 and not this->_channels_state.empty() and
+        Mix_GroupAvailable(-1) < 0) {
+        channel = this->_steal_voice(sound);
+        if (channel < 0) {
+            KAACORE_LOG_DEBUG("No channel available, dropping sound");
+            this->_voices_stats.dropped_voices++;
+            return {-1, 0};
+        }
+    }
+
+    channel = this->_start_channel(sound, loops, channel);
+    if (channel < 0) {
+        KAACORE_LOG_ERROR("Failed to play sound ({})", Mix_GetError());
+        return {-1, 0};
+    }
+    KAACORE_ASSERT(
+        channel < this->_channels_state.size(), "Invalid channel id."
+    );
+    auto& channel_state = this->_channels_state[channel];
+    channel_state.current_sound = sound;
+    channel_state.requested_volume = volume_factor;
+    channel_state.start_order = ++this->_started_voices;
+    auto playback_uid = random_uid<PlaybackUid>();
+    channel_state.playback_uid = playback_uid;
+    this->_recalc_channel_volume(channel);
+    if (deduplicate) {
+        this->_frame_playbacks.emplace_back(sound_data, channel);
+    }
+    KAACORE_LOG_DEBUG(
+        "Playing sound at channel {}, uid: {:#x}", channel, playback_uid
+    );
+    return {channel, playback_uid};
+}
+
+int
+AudioManager::_start_channel(
+    const Sound& sound, const int loops, const int channel
+)
+{
+    if (sound._sound_data->streaming) {
+        return this->_play_stream(*sound._sound_data, loops, channel);
+    }
+    // SDL_mixer loops meaning are different, -1 is infinite, 0 is
+    // once, 1 is twice, ...
+    auto mixer_loops = loops - 1;
+    return Mix_PlayChannel(
+        channel, sound._sound_data->_raw_sound, mixer_loops
+    );
+}
+
+int
+_select_voice_to_steal(
+    const std::vector<_ChannelState>& channels_state, const int priority
+)
+{
+    int victim_channel = -1;
+    for (size_t i = 0; i < channels_state.size(); i++) {
+        const auto& channel_state = channels_state[i];
+        if (not channel_state.current_sound or
+            channel_state.current_sound.priority() > priority) {
+            continue;
+        }
+        if (victim_channel < 0) {
+            victim_channel = i;
+            continue;
+        }
+        const auto& victim_state = channels_state[victim_channel];
+        if (std::make_pair(
+                channel_state.current_sound.priority(),
+                channel_state.start_order
+            ) <
+            std::make_pair(
+                victim_state.current_sound.priority(), victim_state.start_order
+            )) {
+            victim_channel = i;
+        }
+    }
+    return victim_channel;
+}
+
+int
+AudioManager::_steal_voice(const Sound& sound)
+{
+    const int victim_channel =
+        _select_voice_to_steal(this->_channels_state, sound._priority);
+    if (victim_channel >= 0) {
+        KAACORE_LOG_DEBUG(
+            "All channels are busy, stopping channel {}", victim_channel
+        );
+        this->_stop_channel(victim_channel);
+        this->_voices_stats.stolen_voices++;
+    }
+    return victim_channel;
+}
+
+void
+AudioManager::_end_frame()
+{
+    this->_frame_playbacks.clear();
+    const auto stats = this->voices_stats();
+    const auto& reported_stats = this->_reported_voices_stats;
+    auto& stats_manager = get_global_statistics_manager();
+    static const auto active_voices_stat =
+        stats_manager.register_stat("audio.active_voices:count");
+    static const auto stolen_voices_stat =
+        stats_manager.register_stat("audio.stolen_voices:count");
+    static const auto dropped_voices_stat =
+        stats_manager.register_stat("audio.dropped_voices:count");
+    static const auto deduplicated_voices_stat =
+        stats_manager.register_stat("audio.deduplicated_voices:count");
+    stats_manager.push_value(active_voices_stat, stats.active_voices);
+    stats_manager.push_value(
+        stolen_voices_stat, stats.stolen_voices - reported_stats.stolen_voices
+    );
+    stats_manager.push_value(
+        dropped_voices_stat,
+        stats.dropped_voices - reported_stats.dropped_voices
+    );
+    stats_manager.push_value(
+        deduplicated_voices_stat,
+        stats.deduplicated_voices - reported_stats.deduplicated_voices
+    );
+    this->_reported_voices_stats = stats;
+}
+
+int
+AudioManager::_play_stream(
+    const SoundData& sound_data, const int loops, const int channel
+)
+{
+    if (not this->_stream_carrier_chunk) {
+        Mix_SetError("Audio is not opened");
+        return -1;
+    }
+    std::unique_ptr<_SoundStream> sound_stream;
+    try {
+        sound_stream = std::make_unique<_SoundStream>(
+            std::make_unique<WavStreamDecoder>(
+                sound_data.path, this->_mixer_format, this->_mixer_channels,
+                this->_mixer_frequency, loops
+            ),
+            sound_data.stream_buffer_size
+        );
+    } catch (const std::exception& exc) {
+        Mix_SetError("%s", exc.what());
+        return -1;
+    }
+    // playback shouldn't start with buffer underrun
+    sound_stream->fill();
+
+    std::lock_guard lock{this->_streams_lock};
+    auto played_channel =
+        Mix_PlayChannel(channel, this->_stream_carrier_chunk, -1);
+    if (played_channel < 0) {
+        return played_channel;
+    }
+    sound_stream->channel_id = played_channel;
+    if (Mix_RegisterEffect(
+            played_channel, _stream_effect, _stream_effect_done,
+            sound_stream.get()
+        ) == 0) {
+        Mix_HaltChannel(played_channel);
+        return -1;
+    }
+    this->_streams.push_back(std::move(sound_stream));
+    this->_streams_condition.notify_one();
+    return played_channel;
+}
+
+void
+AudioManager::_run_streaming()
+{
+    KAACORE_LOG_DEBUG("Starting sound streaming thread.");
+    std::unique_lock lock{this->_streams_lock};
+    while (this->_streaming_running) {
+        auto& streams = this->_streams;
+        streams.erase(
+            std::remove_if(
+                streams.begin(), streams.end(),
+                [](const auto& sound_stream) { return sound_stream->detached; }
+            ),
+            streams.end()
+        );
+        for (auto& sound_stream : streams) {
+            sound_stream->fill();
+        }
+        this->_streams_condition.wait_for(lock, streaming_interval);
+    }
 }
 
 void
@@ -513,6 +1020,37 @@ AudioManager::mixing_channels(const uint16_t channels)
     this->_channels_state.resize(channels);
 }
 
+size_t
+AudioManager::sound_cache_budget() const
+{
+    return this->_sound_cache->budget();
+}
+
+void
+AudioManager::sound_cache_budget(const size_t budget)
+{
+    this->_sound_cache->budget(budget);
+}
+
+size_t
+AudioManager::sound_cache_usage() const
+{
+    return this->_sound_cache->usage();
+}
+
+AudioVoicesStats
+AudioManager::voices_stats() const
+{
+    auto stats = this->_voices_stats;
+    stats.active_voices = std::count_if(
+        this->_channels_state.begin(), this->_channels_state.end(),
+        [](const auto& channel_state) {
+            return bool(channel_state.current_sound);
+        }
+    );
+    return stats;
+}
+
 double
 AudioManager::master_volume() const
 {
@@ -688,6 +1226,21 @@ AudioManager::_handle_music_finished()
     this->_music_state.current_music = Music(); // empty Music
 }
 
+void
+AudioManager::_handle_stream_finished(ChannelId channel_id)
+{
+    std::lock_guard lock{this->_streams_lock};
+    for (const auto& sound_stream : this->_streams) {
+        // channel could be already stopped and reused
+        if (sound_stream->channel_id == channel_id and
+            sound_stream->finish_requested and not sound_stream->detached) {
+            KAACORE_LOG_DEBUG("Sound stream #{} finished", channel_id);
+            Mix_HaltChannel(channel_id);
+            return;
+        }
+    }
+}
+
 void
 AudioManager::_handle_channel_finished(ChannelId channel_id)
 {
@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <type_traits>
+
+#include "kaacore/easings.h"
+#include "kaacore/exceptions.h"
+#include "kaacore/log.h"
+#include "kaacore/nodes.h"
+#include "kaacore/transitions.h"
+
+#include "kaacore/batched_transitions.h"
+
+namespace kaacore {
+
+using DoubleMicroseconds = std::chrono::duration<double, std::micro>;
+
+template<typename T>
+T
+unpack_batched_transition_value(const glm::dvec4& value);
+
+template<>
+double
+unpack_batched_transition_value<double>(const glm::dvec4& value)
+{
+    return value.x;
+}
+
+template<>
+glm::dvec2
+unpack_batched_transition_value<glm::dvec2>(const glm::dvec4& value)
+{
+    return {value.x, value.y};
+}
+
+template<>
+glm::dvec4
+unpack_batched_transition_value<glm::dvec4>(const glm::dvec4& value)
+{
+    return value;
+}
+
+// Scalar equivalent of TransitionWarping::warp_time followed by
+// normalization done by NodeTransitionCustomizable::process_time_point,
+// kept branch-light so the loop calling it can be vectorized.
+inline double
+batched_transition_progress(
+    const double abs_t, const double internal_duration, const uint32_t loops,
+    const bool back_and_forth
+)
+{
+    if (not(internal_duration > 0.)) {
+        return 1.;
+    }
+    const double period = internal_duration * (1 + back_and_forth);
+    double local_t = abs_t - period * std::floor(abs_t / period);
+    local_t = (loops > 0 and abs_t / period >= loops) ? period : local_t;
+    local_t = (back_and_forth and local_t > internal_duration)
+                  ? std::abs(2 * internal_duration - local_t)
+                  : local_t;
+    return local_t / internal_duration;
+}
+
+template<typename T>
+void
+_BatchedAttributeTransitions<T>::swap_remove(const uint32_t index)
+{
+    const uint32_t last_index = this->size() - 1;
+    auto remove_element = [index, last_index](auto&... vectors) {
+        if (index != last_index) {
+            ((vectors[index] = vectors[last_index]), ...);
+        }
+        (vectors.pop_back(), ...);
+    };
+    remove_element(
+        this->nodes, this->runners, this->origin_values,
+        this->destination_values, this->start_times, this->durations,
+        this->internal_durations, this->loops, this->back_and_forth,
+        this->easings
+    );
+    if (index != last_index) {
+        this->runners[index]->_batch_index = index;
+    }
+}
+
+template<typename Self, typename Func>
+void
+BatchedTransitionsManager::_visit_batch(
+    Self& self, const BatchedTransitionAttribute attribute, Func&& func
+)
+{
+    switch (attribute) {
+        case BatchedTransitionAttribute::position:
+            func(self._position_transitions);
+            break;
+        case BatchedTransitionAttribute::rotation:
+            func(self._rotation_transitions);
+            break;
+        case BatchedTransitionAttribute::scale:
+            func(self._scale_transitions);
+            break;
+        case BatchedTransitionAttribute::color:
+            func(self._color_transitions);
+            break;
+        default:
+            throw kaacore::exception("Unsupported batched transition attribute."
+            );
+    }
+}
+
+void
+BatchedTransitionsManager::add(
+    Node* node, NodeTransitionRunner* runner,
+    const BatchedTransitionParams& params,
+    const HighPrecisionDuration elapsed_time
+)
+{
+    KAACORE_ASSERT(
+        runner->_batch_manager == nullptr,
+        "Transition runner is already batched."
+    );
+    _visit_batch(*this, params.attribute, [&](auto& batch) {
+        using T = typename std::decay_t<decltype(batch.origin_values
+        )>::value_type;
+        runner->_batch_index = batch.size();
+        batch.nodes.push_back(node);
+        batch.runners.push_back(runner);
+        batch.origin_values.push_back(
+            unpack_batched_transition_value<T>(params.origin_value)
+        );
+        batch.destination_values.push_back(
+            unpack_batched_transition_value<T>(params.destination_value)
+        );
+        batch.start_times.push_back((this->_clock - elapsed_time).count());
+        batch.durations.push_back(DoubleMicroseconds(params.duration).count());
+        batch.internal_durations.push_back(
+            DoubleMicroseconds(params.internal_duration).count()
+        );
+        batch.loops.push_back(params.loops);
+        batch.back_and_forth.push_back(params.back_and_forth);
+        batch.easings.push_back(params.easing);
+    });
+    runner->_batch_manager = this;
+    runner->_batch_attribute = params.attribute;
+    node->_transitions_manager._batched_runners_count++;
+}
+
+void
+BatchedTransitionsManager::remove(NodeTransitionRunner* runner)
+{
+    KAACORE_ASSERT(
+        runner->_batch_manager == this,
+        "Transition runner is not batched by this manager."
+    );
+    _visit_batch(*this, runner->_batch_attribute, [runner](auto& batch) {
+        const auto index = runner->_batch_index;
+        KAACORE_ASSERT(
+            index < batch.size() and batch.runners[index] == runner,
+            "Invalid internal state of batched transitions."
+        );
+        batch.nodes[index]->_transitions_manager._batched_runners_count--;
+        batch.swap_remove(index);
+    });
+    runner->_batch_manager = nullptr;
+    runner->_batch_attribute = BatchedTransitionAttribute::none;
+}
+
+HighPrecisionDuration
+BatchedTransitionsManager::elapsed_time(const NodeTransitionRunner* runner
+) const
+{
+    KAACORE_ASSERT(
+        runner->_batch_manager == this,
+        "Transition runner is not batched by this manager."
+    );
+    HighPrecisionDuration::rep start_time;
+    _visit_batch(
+        *this, runner->_batch_attribute,
+        [runner, &start_time](const auto& batch) {
+            start_time = batch.start_times[runner->_batch_index];
+        }
+    );
+    return this->_clock - HighPrecisionDuration(start_time);
+}
+
+void
+BatchedTransitionsManager::elapsed_time(
+    NodeTransitionRunner* runner, const HighPrecisionDuration elapsed_time
+)
+{
+    KAACORE_ASSERT(
+        runner->_batch_manager == this,
+        "Transition runner is not batched by this manager."
+    );
+    _visit_batch(
+        *this, runner->_batch_attribute,
+        [this, runner, elapsed_time](auto& batch) {
+            batch.start_times[runner->_batch_index] =
+                (this->_clock - elapsed_time).count();
+        }
+    );
+}
+
+std::pair<glm::dvec4, glm::dvec4>
+BatchedTransitionsManager::transition_values(const NodeTransitionRunner* runner
+) const
+{
+    KAACORE_ASSERT(
+        runner->_batch_manager == this,
+        "Transition runner is not batched by this manager."
+    );
+    std::pair<glm::dvec4, glm::dvec4> values;
+    _visit_batch(
+        *this, runner->_batch_attribute, [runner, &values](const auto& batch) {
+            const auto index = runner->_batch_index;
+            values = {
+                pack_batched_transition_value(batch.origin_values[index]),
+                pack_batched_transition_value(batch.destination_values[index])
+            };
+        }
+    );
+    return values;
+}
+
+size_t
+BatchedTransitionsManager::size() const
+{
+    return this->_position_transitions.size() +
+           this->_rotation_transitions.size() +
+           this->_scale_transitions.size() + this->_color_transitions.size();
+}
+
+template<typename T, typename Func>
+void
+BatchedTransitionsManager::_process_batch(
+    _BatchedAttributeTransitions<T>& batch, Func&& apply
+)
+{
+    const size_t count = batch.size();
+    if (count == 0) {
+        return;
+    }
+    batch.progress.resize(count);
+    batch.finished.resize(count);
+
+    const auto clock = this->_clock.count();
+    for (size_t i = 0; i < count; i++) {
+        const double abs_t = clock - batch.start_times[i];
+        batch.finished[i] = abs_t >= batch.durations[i];
+        batch.progress[i] = batched_transition_progress(
+            abs_t, batch.internal_durations[i], batch.loops[i],
+            batch.back_and_forth[i]
+        );
+    }
+
+    // most commonly all transitions in batch share the same easing
+    const Easing easing = batch.easings[0];
+    if (std::all_of(
+            batch.easings.begin(), batch.easings.end(),
+            [easing](const Easing other) { return other == easing; }
+        )) {
+        ease_batch(
+            easing, batch.progress.data(), batch.progress.data(), count
+        );
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            batch.progress[i] = ease(batch.easings[i], batch.progress[i]);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        Node* node = batch.nodes[i];
+        if (node->_marked_to_delete) {
+            continue;
+        }
+        apply(
+            node, glm::mix(
+                      batch.origin_values[i], batch.destination_values[i],
+                      batch.progress[i]
+                  )
+        );
+        if (batch.finished[i]) {
+            this->_finished_transitions.emplace_back(node, batch.runners[i]);
+        }
+    }
+}
+
+void
+BatchedTransitionsManager::process(const HighPrecisionDuration dt)
+{
+    this->_clock += dt;
+    this->_finished_transitions.clear();
+
+    this->_process_batch(
+        this->_position_transitions,
+        [](Node* node, const glm::dvec2& value) { node->position(value); }
+    );
+    this->_process_batch(
+        this->_rotation_transitions,
+        [](Node* node, const double value) { node->rotation(value); }
+    );
+    this->_process_batch(
+        this->_scale_transitions,
+        [](Node* node, const glm::dvec2& value) { node->scale(value); }
+    );
+    this->_process_batch(
+        this->_color_transitions,
+        [](Node* node, const glm::dvec4& value) { node->color(value); }
+    );
+
+    // removing runner from node's transitions manager
+    // will also remove it from batch
+    for (auto [node, runner] : this->_finished_transitions) {
+        node->_transitions_manager._remove_runner(runner);
+    }
+}
+
+} // namespace kaacore
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "kaacore/log.h"
+
+#include "kaacore/compression.h"
+
+namespace kaacore {
+
+constexpr size_t lz4_min_match = 4;
+// last match must start at least 12 bytes before end of input
+constexpr size_t lz4_match_start_limit = 12;
+// last 5 bytes are always literals
+constexpr size_t lz4_last_literals = 5;
+constexpr size_t lz4_max_offset = 65535;
+constexpr uint32_t lz4_hash_bits = 12;
+
+inline uint32_t
+_read_uint32(const std::byte* data)
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint32_t
+_lz4_hash(const uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - lz4_hash_bits);
+}
+
+inline void
+_lz4_write_length(std::vector<std::byte>& output, size_t length)
+{
+    while (length >= 255) {
+        output.push_back(std::byte(255));
+        length -= 255;
+    }
+    output.push_back(std::byte(length));
+}
+
+void
+_lz4_write_sequence(
+    std::vector<std::byte>& output, const std::byte* literals,
+    const size_t literals_length, const size_t offset,
+    const size_t match_length
+)
+{
+    const size_t match_code = match_length ? match_length - lz4_min_match : 0;
+    const size_t literals_token = std::min<size_t>(literals_length, 15);
+    const size_t match_token = std::min<size_t>(match_code, 15);
+    output.push_back(std::byte((literals_token << 4) | match_token));
+    if (literals_length >= 15) {
+        _lz4_write_length(output, literals_length - 15);
+    }
+    output.insert(output.end(), literals, literals + literals_length);
+    if (match_length == 0) {
+        return;
+    }
+    output.push_back(std::byte(offset & 0xFF));
+    output.push_back(std::byte(offset >> 8));
+    if (match_code >= 15) {
+        _lz4_write_length(output, match_code - 15);
+    }
+}
+
+inline bool
+_lz4_read_length(
+    const std::byte* data, const size_t size, size_t& position,
+    size_t& length
+)
+{
+    uint8_t value;
+    do {
+        if (position >= size) {
+            return false;
+        }
+        value = uint8_t(data[position++]);
+        length += value;
+    } while (value == 255);
+    return true;
+}
+
+size_t
+lz4_compress_bound(const size_t size)
+{
+    return size + (size / 255) + 16;
+}
+
+std::vector<std::byte>
+lz4_compress(const std::byte* data, const size_t size)
+{
+    std::vector<std::byte> output;
+    output.reserve(lz4_compress_bound(size));
+    if (size <= lz4_match_start_limit) {
+        _lz4_write_sequence(output, data, size, 0, 0);
+        return output;
+    }
+
+    // positions are stored +1, so zero marks empty slot
+    std::vector<uint32_t> hash_table(1u << lz4_hash_bits, 0);
+    const size_t match_start_limit = size - lz4_match_start_limit;
+    const size_t match_end_limit = size - lz4_last_literals;
+    size_t anchor = 0;
+    size_t position = 0;
+    while (position < match_start_limit) {
+        const uint32_t sequence = _read_uint32(data + position);
+        auto& slot = hash_table[_lz4_hash(sequence)];
+        const size_t candidate = slot;
+        slot = position + 1;
+        if (candidate == 0 or position - (candidate - 1) > lz4_max_offset or
+            _read_uint32(data + candidate - 1) != sequence) {
+            position++;
+            continue;
+        }
+
+        const size_t reference = candidate - 1;
+        size_t match_length = lz4_min_match;
+        while (position + match_length < match_end_limit and
+               data[reference + match_length] ==
+                   data[position + match_length]) {
+            match_length++;
+        }
+        _lz4_write_sequence(
+            output, data + anchor, position - anchor, position - reference,
+            match_length
+        );
+        position += match_length;
+        anchor = position;
+    }
+    _lz4_write_sequence(output, data + anchor, size - anchor, 0, 0);
+    return output;
+}
+
+bool
+lz4_decompress(
+    const std::byte* data, const size_t size, std::byte* decompressed,
+    const size_t decompressed_size
+)
+{
+    size_t input_position = 0;
+    size_t output_position = 0;
+    while (input_position < size) {
+        const uint8_t token = uint8_t(data[input_position++]);
+        size_t literals_length = token >> 4;
+        if (literals_length == 15 and
+            not _lz4_read_length(data, size, input_position, literals_length)) {
+            return false;
+        }
+        if (literals_length > size - input_position or
+            literals_length > decompressed_size - output_position) {
+            return false;
+        }
+        if (literals_length > 0) {
+            std::memcpy(
+                decompressed + output_position, data + input_position,
+                literals_length
+            );
+        }
+        input_position += literals_length;
+        output_position += literals_length;
+        if (input_position == size) {
+            break;
+        }
+
+        if (size - input_position < 2) {
+            return false;
+        }
+        const size_t offset = size_t(data[input_position]) |
+                              (size_t(data[input_position + 1]) << 8);
+        input_position += 2;
+        size_t match_length = token & 0x0F;
+        if (match_length == 15 and
+            not _lz4_read_length(data, size, input_position, match_length)) {
+            return false;
+        }
+        match_length += lz4_min_match;
+        if (offset == 0 or offset > output_position or
+            match_length > decompressed_size - output_position) {
+            return false;
+        }
+        // match may overlap output, so it's copied in non-overlapping
+        // chunks, each one twice as long as previous one
+        const size_t match_position = output_position - offset;
+        while (match_length > 0) {
+            const size_t chunk_length =
+                std::min(match_length, output_position - match_position);
+            std::memcpy(
+                decompressed + output_position, decompressed + match_position,
+                chunk_length
+            );
+            output_position += chunk_length;
+            match_length -= chunk_length;
+        }
+    }
+    return output_position == decompressed_size;
+}
+
+} // namespace kaacore
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/constants.hpp>
 #include <glm/gtx/easing.hpp>
 
 #include "kaacore/easings.h"
@@ -78,4 +82,216 @@ ease(const Easing easing, const double progress)
     }
 }
 
+template<typename Func>
+inline void
+ease_loop(
+    const double* progress, double* output, const size_t count, Func&& func
+)
+{
+    for (size_t i = 0; i < count; i++) {
+        output[i] = func(progress[i]);
+    }
+}
+
+// Piecewise functions below evaluate all pieces and select the result,
+// which lets compiler turn branches into blends.
+
+inline double
+bounce_out_branchless(const double p)
+{
+    const double a = (121. * p * p) / 16.;
+    const double b = (363. / 40. * p * p) - (99. / 10. * p) + 17. / 5.;
+    const double c =
+        (4356. / 361. * p * p) - (35442. / 1805. * p) + 16061. / 1805.;
+    const double d = (54. / 5. * p * p) - (513. / 25. * p) + 268. / 25.;
+    return p < 4. / 11. ? a : (p < 8. / 11. ? b : (p < 9. / 10. ? c : d));
+}
+
+void
+ease_batch(
+    const Easing easing, const double* progress, double* output,
+    const size_t count
+)
+{
+    constexpr double back_overshoot = 1.70158;
+    constexpr double back_in_out_overshoot = back_overshoot * 1.525;
+
+    switch (easing) {
+        case Easing::back_in:
+            ease_loop(progress, output, count, [](const double p) {
+                return p * p * (((back_overshoot + 1.) * p) - back_overshoot);
+            });
+            break;
+        case Easing::back_in_out:
+            ease_loop(progress, output, count, [](const double p) {
+                constexpr double s = back_in_out_overshoot;
+                const double m = p * 2. - 2.;
+                const double in =
+                    0.5 * p * 2. * p * 2. * (((s + 1.) * p * 2.) - s);
+                const double out = 0.5 * (m * m * (((s + 1.) * m) + s) + 2.);
+                return p < 0.5 ? in : out;
+            });
+            break;
+        case Easing::back_out:
+            ease_loop(progress, output, count, [](const double p) {
+                const double n = p - 1.;
+                return n * n * (((back_overshoot + 1.) * n) + back_overshoot) +
+                       1.;
+            });
+            break;
+        case Easing::bounce_in:
+            ease_loop(progress, output, count, [](const double p) {
+                return 1. - bounce_out_branchless(1. - p);
+            });
+            break;
+        case Easing::bounce_in_out:
+            // see the glm workaround in `ease`
+            ease_loop(progress, output, count, [](const double p) {
+                const double in =
+                    (1. - bounce_out_branchless(1. - 2. * p)) * 0.5;
+                const double out =
+                    0.5 * bounce_out_branchless(p * 2. - 1.) + 0.5;
+                return p < 0.5 ? in : out;
+            });
+            break;
+        case Easing::bounce_out:
+            ease_loop(progress, output, count, bounce_out_branchless);
+            break;
+        case Easing::circular_in:
+            ease_loop(progress, output, count, [](const double p) {
+                return 1. - std::sqrt(1. - (p * p));
+            });
+            break;
+        case Easing::circular_in_out:
+            ease_loop(progress, output, count, [](const double p) {
+                const double in = 0.5 * (1. - std::sqrt(1. - 4. * (p * p)));
+                const double out =
+                    0.5 * (std::sqrt(-((2. * p) - 3.) * ((2. * p) - 1.)) + 1.);
+                return p < 0.5 ? in : out;
+            });
+            break;
+        case Easing::circular_out:
+            ease_loop(progress, output, count, [](const double p) {
+                return std::sqrt((2. - p) * p);
+            });
+            break;
+        case Easing::cubic_in:
+            ease_loop(progress, output, count, [](const double p) {
+                return p * p * p;
+            });
+            break;
+        case Easing::cubic_in_out:
+            ease_loop(progress, output, count, [](const double p) {
+                const double f = (2. * p) - 2.;
+                return p < 0.5 ? 4. * p * p * p : 0.5 * f * f * f + 1.;
+            });
+            break;
+        case Easing::cubic_out:
+            ease_loop(progress, output, count, [](const double p) {
+                const double f = p - 1.;
+                return f * f * f + 1.;
+            });
+            break;
+        case Easing::elastic_in:
+            ease_loop(progress, output, count, [](const double p) {
+                return glm::elasticEaseIn(p);
+            });
+            break;
+        case Easing::elastic_in_out:
+            ease_loop(progress, output, count, [](const double p) {
+                return glm::elasticEaseInOut(p);
+            });
+            break;
+        case Easing::elastic_out:
+            ease_loop(progress, output, count, [](const double p) {
+                return glm::elasticEaseOut(p);
+            });
+            break;
+        case Easing::exponential_in:
+            ease_loop(progress, output, count, [](const double p) {
+                return glm::exponentialEaseIn(p);
+            });
+            break;
+        case Easing::exponential_in_out:
+            ease_loop(progress, output, count, [](const double p) {
+                return glm::exponentialEaseInOut(p);
+            });
+            break;
+        case Easing::exponential_out:
+            ease_loop(progress, output, count, [](const double p) {
+                return glm::exponentialEaseOut(p);
+            });
+            break;
+        case Easing::quadratic_in:
+            ease_loop(progress, output, count, [](const double p) {
+                return p * p;
+            });
+            break;
+        case Easing::quadratic_in_out:
+            ease_loop(progress, output, count, [](const double p) {
+                return p < 0.5 ? 2. * p * p : (-2. * p * p) + (4. * p) - 1.;
+            });
+            break;
+        case Easing::quadratic_out:
+            ease_loop(progress, output, count, [](const double p) {
+                return -(p * (p - 2.));
+            });
+            break;
+        case Easing::quartic_in:
+            ease_loop(progress, output, count, [](const double p) {
+                return p * p * p * p;
+            });
+            break;
+        case Easing::quartic_in_out:
+            ease_loop(progress, output, count, [](const double p) {
+                const double f = p - 1.;
+                return p < 0.5 ? 8. * p * p * p * p : -8. * f * f * f * f + 1.;
+            });
+            break;
+        case Easing::quartic_out:
+            ease_loop(progress, output, count, [](const double p) {
+                const double f = p - 1.;
+                return f * f * f * (1. - p) + 1.;
+            });
+            break;
+        case Easing::quintic_in:
+            ease_loop(progress, output, count, [](const double p) {
+                return p * p * p * p * p;
+            });
+            break;
+        case Easing::quintic_in_out:
+            ease_loop(progress, output, count, [](const double p) {
+                const double f = (2. * p) - 2.;
+                return p < 0.5 ? 16. * p * p * p * p * p
+                               : 0.5 * f * f * f * f * f + 1.;
+            });
+            break;
+        case Easing::quintic_out:
+            ease_loop(progress, output, count, [](const double p) {
+                const double f = p - 1.;
+                return f * f * f * f * f + 1.;
+            });
+            break;
+        case Easing::sine_in:
+            ease_loop(progress, output, count, [](const double p) {
+                return std::sin((p - 1.) * glm::half_pi<double>()) + 1.;
+            });
+            break;
+        case Easing::sine_in_out:
+            ease_loop(progress, output, count, [](const double p) {
+                return 0.5 * (1. - std::cos(p * glm::pi<double>()));
+            });
+            break;
+        case Easing::sine_out:
+            ease_loop(progress, output, count, [](const double p) {
+                return std::sin(p * glm::half_pi<double>());
+            });
+            break;
+        default:
+            if (output != progress) {
+                std::copy(progress, progress + count, output);
+            }
+    }
+}
+
 } // namespace kaacore
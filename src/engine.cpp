@@ -1,5 +1,6 @@
 #include <cassert>
 #include <chrono>
+#include <cstdlib>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -11,11 +12,14 @@
 #include "kaacore/audio.h"
 #include "kaacore/display.h"
 #include "kaacore/exceptions.h"
+#include "kaacore/fonts.h"
 #include "kaacore/input.h"
 #include "kaacore/log.h"
 #include "kaacore/platform.h"
 #include "kaacore/scenes.h"
 #include "kaacore/statistics.h"
+#include "kaacore/textures.h"
+#include "kaacore/tracing.h"
 
 #include "kaacore/engine.h"
 
@@ -142,6 +146,7 @@ Engine::Engine(
     );
 
     this->_main_thread_id = std::this_thread::get_id();
+    KAACORE_TRACE_THREAD_NAME("main");
     this->window = std::make_unique<Window>(this->_virtual_resolution);
 
     auto bgfx_init_data = this->_gather_platform_data();
@@ -154,6 +159,7 @@ Engine::Engine(
                          // meaning it will talk with system graphics.
     this->_engine_loop_thread =
         std::thread{[this, bgfx_init_data, window_size]() {
+            KAACORE_TRACE_THREAD_NAME("engine");
             this->renderer = std::make_unique<Renderer>(
                 bgfx_init_data, window_size, this->_virtual_resolution,
                 this->_virtual_resolution_mode
@@ -225,6 +231,11 @@ Engine::~Engine()
 
     this->window.reset();
     SDL_Quit();
+#if KAACORE_TRACING
+    if (const char* trace_path = std::getenv(trace_output_env_name)) {
+        write_trace(trace_path);
+    }
+#endif
     engine = nullptr;
 }
 
@@ -401,6 +412,11 @@ Engine::_gather_platform_data()
 void
 Engine::_scene_processing()
 {
+    auto& stats_manager = get_global_statistics_manager();
+    static const auto frame_stat =
+        stats_manager.register_stat("engine.frame:time");
+    static const auto update_stat =
+        stats_manager.register_stat("scene.update:time");
     this->is_running = true;
     try {
         KAACORE_LOG_INFO("Engine is running.");
@@ -408,22 +424,36 @@ Engine::_scene_processing()
         while (this->is_running) {
             auto dt = this->clock.measure();
             {
-                StopwatchStatAutoPusher stopwatch{"engine.frame:time"};
+                KAACORE_TRACE_SCOPE("engine", "frame");
+                StopwatchStatAutoPusher stopwatch{frame_stat};
 #if KAACORE_MULTITHREADING_MODE
                 this->_event_processing_state.wait(EventProcessingState::ready);
 #endif
-                this->_process_events();
+                {
+                    KAACORE_TRACE_SCOPE("engine", "process_events");
+                    this->_process_events();
+                }
                 if (this->_next_scene) {
                     this->_swap_scenes();
                 }
-                Duration scaled_dt_sec = dt * this->_scene->_time_scale;
-                auto scaled_dt =
-                    std::chrono::duration_cast<HighPrecisionDuration>(
-                        scaled_dt_sec
-                    );
+                process_pending_textures();
+                Duration scaled_dt_sec;
+                HighPrecisionDuration scaled_dt;
+                if (this->_scene->_fixed_time_step) {
+                    // avoid round trip through floating point duration
+                    scaled_dt = *this->_scene->_fixed_time_step;
+                    scaled_dt_sec = scaled_dt;
+                } else {
+                    scaled_dt_sec = dt * this->_scene->_time_scale;
+                    scaled_dt =
+                        std::chrono::duration_cast<HighPrecisionDuration>(
+                            scaled_dt_sec
+                        );
+                }
                 this->_total_time += scaled_dt_sec;
                 {
-                    StopwatchStatAutoPusher stopwatch{"scene.update:time"};
+                    KAACORE_TRACE_SCOPE("scene", "update");
+                    StopwatchStatAutoPusher stopwatch{update_stat};
                     this->_scene->process_update(scaled_dt_sec);
                 }
 #if KAACORE_MULTITHREADING_MODE
@@ -437,21 +467,31 @@ Engine::_scene_processing()
                 this->_scene->attach_frame_context(this->renderer);
                 this->renderer->begin_frame();
                 this->_scene->render(this->renderer);
-                this->renderer->end_frame();
+                {
+                    KAACORE_TRACE_SCOPE("renderer", "end_frame");
+                    this->renderer->end_frame();
+                }
                 this->_scene->resolve_spatial_index_changes(
                     nodes_processing_queue
                 );
                 this->_scene->process_physics(scaled_dt);
-                this->timers.process(dt);
-                this->_scene->timers.process(scaled_dt);
+                {
+                    KAACORE_TRACE_SCOPE("engine", "timers");
+                    this->timers.process(dt);
+                    this->_scene->timers.process(scaled_dt);
+                }
                 this->_scene->process_nodes(scaled_dt, nodes_processing_queue);
                 this->_scene->remove_marked_nodes();
+                KAACORE_TRACE_SCOPE("engine", "end_frame");
+                push_fonts_statistics();
+                update_textures_residency();
+                this->audio_manager->_end_frame();
             }
+            stats_manager.flush();
 
             if (this->udp_stats_exporter) {
                 this->renderer->push_statistics();
-                this->udp_stats_exporter->send_sync(
-                    get_global_statistics_manager().get_last_all()
+                this->udp_stats_exporter->send_sync(stats_manager.get_last_all()
                 );
             }
         }
@@ -498,6 +538,8 @@ Engine::_process_events()
             this->audio_manager->_handle_music_finished();
         } else if (event.type == EventType::channel_finished) {
             this->audio_manager->_handle_channel_finished(event.user.code);
+        } else if (event.type == EventType::_sound_stream_finished) {
+            this->audio_manager->_handle_stream_finished(event.user.code);
         } else if (event.type == SDL_WINDOWEVENT and
                    event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
             this->_reset({event.window.data1, event.window.data2});
@@ -521,14 +563,22 @@ Engine::_main_thread_entrypoint()
     this->_engine_loop_state.set(EngineLoopState::starting);
 
     while (true) {
-        do {
-            this->_synced_syscall_queue.finalize_calls();
-        } while (this->is_running and
-                 not this->_event_processing_state.wait_for(
-                     EventProcessingState::consumed, threads_sync_timeout
-                 ));
-        SDL_PumpEvents();
+        KAACORE_TRACE_SCOPE("main", "main_loop");
+        {
+            KAACORE_TRACE_SCOPE("main", "wait_events_consumed");
+            do {
+                this->_synced_syscall_queue.finalize_calls();
+            } while (this->is_running and
+                     not this->_event_processing_state.wait_for(
+                         EventProcessingState::consumed, threads_sync_timeout
+                     ));
+        }
+        {
+            KAACORE_TRACE_SCOPE("main", "pump_events");
+            SDL_PumpEvents();
+        }
         this->_event_processing_state.set(EventProcessingState::ready);
+        KAACORE_TRACE_SCOPE("main", "render_frame");
         do {
             this->_synced_syscall_queue.finalize_calls();
         } while (bgfx::renderFrame(
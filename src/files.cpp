@@ -1,5 +1,18 @@
+#include <cstdio>
 #include <functional>
+#include <memory>
+#include <utility>
 
+#if _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "kaacore/archives.h"
 #include "kaacore/exceptions.h"
 #include "kaacore/log.h"
 
@@ -10,6 +23,11 @@ namespace kaacore {
 File::File(const std::string& path) noexcept(false) : path(path)
 {
     KAACORE_LOG_INFO("Reading file: {}", path);
+    if (auto memory = read_mounted_file(path)) {
+        auto bytes = reinterpret_cast<const uint8_t*>(memory->get());
+        this->content.assign(bytes, bytes + memory->size());
+        return;
+    }
     std::ifstream f(path, std::ifstream::binary);
     if (f.fail()) {
         throw std::ios_base::failure("Failed to open file: " + path);
@@ -20,4 +38,153 @@ File::File(const std::string& path) noexcept(false) : path(path)
     this->content.resize(len);
     f.read(reinterpret_cast<char*>(this->content.data()), len);
 }
+
+#if _WIN32
+
+MappedFile::MappedFile(const std::string& path) noexcept(false) : path(path)
+{
+    KAACORE_LOG_DEBUG("Mapping file: {}", path);
+    this->_file_handle = CreateFileA(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+    if (this->_file_handle == INVALID_HANDLE_VALUE) {
+        this->_file_handle = nullptr;
+        throw std::ios_base::failure("Failed to open file: " + path);
+    }
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(this->_file_handle, &file_size);
+    this->_size = file_size.QuadPart;
+    if (this->_size == 0) {
+        return;
+    }
+
+    this->_mapping_handle = CreateFileMappingA(
+        this->_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr
+    );
+    const void* view = this->_mapping_handle
+                           ? MapViewOfFile(
+                                 this->_mapping_handle, FILE_MAP_READ, 0, 0, 0
+                             )
+                           : nullptr;
+    if (view == nullptr) {
+        if (this->_mapping_handle) {
+            CloseHandle(this->_mapping_handle);
+        }
+        CloseHandle(this->_file_handle);
+        throw std::ios_base::failure("Failed to map file: " + path);
+    }
+    this->_data = static_cast<const std::byte*>(view);
+}
+
+MappedFile::~MappedFile()
+{
+    if (this->_data) {
+        UnmapViewOfFile(this->_data);
+    }
+    if (this->_mapping_handle) {
+        CloseHandle(this->_mapping_handle);
+    }
+    if (this->_file_handle) {
+        CloseHandle(this->_file_handle);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) noexcept(false) : path(path)
+{
+    KAACORE_LOG_DEBUG("Mapping file: {}", path);
+    this->_file_descriptor = open(path.c_str(), O_RDONLY);
+    if (this->_file_descriptor < 0) {
+        throw std::ios_base::failure("Failed to open file: " + path);
+    }
+    struct stat file_stat;
+    if (fstat(this->_file_descriptor, &file_stat) != 0) {
+        close(this->_file_descriptor);
+        throw std::ios_base::failure("Failed to stat file: " + path);
+    }
+    this->_size = file_stat.st_size;
+    if (this->_size == 0) {
+        return;
+    }
+
+    void* view = mmap(
+        nullptr, this->_size, PROT_READ, MAP_PRIVATE, this->_file_descriptor, 0
+    );
+    if (view == MAP_FAILED) {
+        close(this->_file_descriptor);
+        throw std::ios_base::failure("Failed to map file: " + path);
+    }
+    this->_data = static_cast<const std::byte*>(view);
+}
+
+MappedFile::~MappedFile()
+{
+    if (this->_data) {
+        munmap(const_cast<std::byte*>(this->_data), this->_size);
+    }
+    if (this->_file_descriptor >= 0) {
+        close(this->_file_descriptor);
+    }
+}
+
+#endif
+
+const std::byte*
+MappedFile::data() const
+{
+    return this->_data;
+}
+
+size_t
+MappedFile::size() const
+{
+    return this->_size;
+}
+
+Memory
+map_file(const std::string& path) noexcept(false)
+{
+    if (auto memory = read_mounted_file(path)) {
+        return std::move(*memory);
+    }
+    auto mapped_file = std::make_shared<MappedFile>(path);
+    const size_t size = mapped_file->size();
+    auto data = const_cast<std::byte*>(mapped_file->data());
+    return Memory::share(
+        std::shared_ptr<std::byte>(std::move(mapped_file), data), size
+    );
+}
+
+bool
+write_file(const std::string& path, const std::byte* data, const size_t size)
+{
+    // write to temporary file first, so readers never see partial content
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream f(tmp_path, std::ofstream::binary | std::ofstream::trunc);
+        if (f.fail()) {
+            KAACORE_LOG_WARN("Failed to open file for writing: {}", tmp_path);
+            return false;
+        }
+        f.write(reinterpret_cast<const char*>(data), size);
+        if (f.fail()) {
+            KAACORE_LOG_WARN("Failed to write file: {}", tmp_path);
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        // rename does not overwrite existing files on some platforms
+        std::remove(path.c_str());
+        if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+            KAACORE_LOG_WARN("Failed to write file: {}", path);
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
 } // namespace kaacore
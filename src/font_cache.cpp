@@ -0,0 +1,198 @@
+#include <cstdlib>
+#include <cstring>
+#include <ios>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "kaacore/exceptions.h"
+#include "kaacore/files.h"
+#include "kaacore/log.h"
+#include "kaacore/textures.h"
+
+#include "kaacore/font_cache.h"
+
+namespace kaacore {
+
+constexpr uint32_t font_cache_magic = 0x544E464B; // "KFNT"
+constexpr uint16_t font_cache_version = 1;
+constexpr uint64_t fnv1a_offset_basis = 0xcbf29ce484222325ULL;
+constexpr uint64_t fnv1a_prime = 0x100000001b3ULL;
+
+struct _FontCacheHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t packed_char_size;
+    uint64_t key;
+    uint32_t width;
+    uint32_t height;
+    uint32_t glyphs_count;
+    uint32_t reserved;
+    double ascent;
+    double descent;
+    double line_gap;
+};
+
+static_assert(std::is_trivially_copyable_v<_FontCacheHeader>);
+static_assert(std::is_trivially_copyable_v<stbtt_packedchar>);
+
+std::mutex _font_cache_directory_lock;
+std::optional<std::string> _font_cache_directory;
+
+std::string
+get_font_cache_directory()
+{
+    std::lock_guard lock{_font_cache_directory_lock};
+    if (not _font_cache_directory) {
+        const char* directory_env = std::getenv("KAACORE_FONT_CACHE_DIR");
+        _font_cache_directory = directory_env ? directory_env : "";
+    }
+    return *_font_cache_directory;
+}
+
+void
+set_font_cache_directory(const std::string& directory)
+{
+    std::lock_guard lock{_font_cache_directory_lock};
+    _font_cache_directory = directory;
+}
+
+inline uint64_t
+_fnv1a_update(uint64_t hash, const void* data, const size_t size)
+{
+    const auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * fnv1a_prime;
+    }
+    return hash;
+}
+
+template<typename T>
+inline uint64_t
+_fnv1a_update(uint64_t hash, const T& value)
+{
+    static_assert(std::is_arithmetic_v<T>);
+    return _fnv1a_update(hash, &value, sizeof(T));
+}
+
+uint64_t
+calculate_font_cache_key(const std::byte* font_data, const size_t size)
+{
+    uint64_t hash = _fnv1a_update(fnv1a_offset_basis, font_data, size);
+    hash = _fnv1a_update(hash, font_cache_version);
+    hash = _fnv1a_update(hash, font_baker_texture_width);
+    hash = _fnv1a_update(hash, font_baker_texture_max_height);
+    hash = _fnv1a_update(hash, font_baker_pixel_height);
+    hash = _fnv1a_update(hash, font_baker_first_glyph);
+    hash = _fnv1a_update(hash, font_baker_glyphs_count);
+    hash = _fnv1a_update(hash, font_sdf_padding);
+    hash = _fnv1a_update(hash, font_sdf_edge_value);
+    hash = _fnv1a_update(hash, font_sdf_pixel_dist_scale);
+    return hash;
+}
+
+std::string
+get_font_cache_path(const std::string& directory, const uint64_t key)
+{
+    return fmt::format("{}/{:016x}.kfc", directory, key);
+}
+
+std::optional<BakedFontAtlas>
+load_font_cache(const std::string& directory, const uint64_t key)
+{
+    const auto path = get_font_cache_path(directory, key);
+    std::optional<MappedFile> file;
+    try {
+        file.emplace(path);
+    } catch (const std::ios_base::failure&) {
+        KAACORE_LOG_DEBUG("Font cache file not found: {}", path);
+        return std::nullopt;
+    }
+
+    _FontCacheHeader header;
+    if (file->size() < sizeof(header)) {
+        KAACORE_LOG_WARN("Font cache file is truncated: {}", path);
+        return std::nullopt;
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (header.magic != font_cache_magic or
+        header.version != font_cache_version or
+        header.packed_char_size != sizeof(stbtt_packedchar) or
+        header.key != key or header.glyphs_count != font_baker_glyphs_count) {
+        KAACORE_LOG_WARN("Font cache file is invalid: {}", path);
+        return std::nullopt;
+    }
+
+    const size_t glyphs_size = header.glyphs_count * sizeof(stbtt_packedchar);
+    const size_t pixels_size = size_t(header.width) * header.height;
+    if (file->size() != sizeof(header) + glyphs_size + pixels_size or
+        header.width > font_baker_texture_width or
+        header.height > font_baker_texture_max_height) {
+        KAACORE_LOG_WARN("Font cache file is invalid: {}", path);
+        return std::nullopt;
+    }
+
+    const std::byte* glyphs_data = file->data() + sizeof(header);
+    BakedFontData baked_font_data(header.glyphs_count);
+    std::memcpy(baked_font_data.data(), glyphs_data, glyphs_size);
+    bimg::ImageContainer* image_container = load_raw_image(
+        bimg::TextureFormat::Enum::R8, header.width, header.height,
+        reinterpret_cast<const uint8_t*>(glyphs_data + glyphs_size)
+    );
+
+    KAACORE_LOG_DEBUG(
+        "Loaded font atlas from cache: {}, size: ({}, {})", path, header.width,
+        header.height
+    );
+    return BakedFontAtlas{
+        image_container, std::move(baked_font_data),
+        FontMetrics{header.ascent, header.descent, header.line_gap}
+    };
+}
+
+bool
+store_font_cache(
+    const std::string& directory, const uint64_t key,
+    const BakedFontAtlas& atlas
+)
+{
+    const auto& [image_container, baked_font_data, font_metrics] = atlas;
+    KAACORE_CHECK(
+        image_container->m_format == bimg::TextureFormat::Enum::R8,
+        "Font atlas must use R8 format."
+    );
+
+    _FontCacheHeader header{};
+    header.magic = font_cache_magic;
+    header.version = font_cache_version;
+    header.packed_char_size = sizeof(stbtt_packedchar);
+    header.key = key;
+    header.width = image_container->m_width;
+    header.height = image_container->m_height;
+    header.glyphs_count = baked_font_data.size();
+    header.ascent = font_metrics.ascent;
+    header.descent = font_metrics.descent;
+    header.line_gap = font_metrics.line_gap;
+
+    const size_t glyphs_size = header.glyphs_count * sizeof(stbtt_packedchar);
+    const size_t pixels_size = size_t(header.width) * header.height;
+    std::vector<std::byte> buffer(sizeof(header) + glyphs_size + pixels_size);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(
+        buffer.data() + sizeof(header), baked_font_data.data(), glyphs_size
+    );
+    std::memcpy(
+        buffer.data() + sizeof(header) + glyphs_size, image_container->m_data,
+        pixels_size
+    );
+
+    const auto path = get_font_cache_path(directory, key);
+    if (not write_file(path, buffer.data(), buffer.size())) {
+        KAACORE_LOG_WARN("Failed to store font cache file: {}", path);
+        return false;
+    }
+    KAACORE_LOG_DEBUG("Stored font atlas in cache: {}", path);
+    return true;
+}
+
+} // namespace kaacore
@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <vector>
 
 #include "stb_rect_pack.h"
@@ -8,9 +12,12 @@
 #include "kaacore/embedded_data.h"
 #include "kaacore/engine.h"
 #include "kaacore/exceptions.h"
+#include "kaacore/font_cache.h"
 #include "kaacore/fonts.h"
 #include "kaacore/nodes.h"
+#include "kaacore/statistics.h"
 #include "kaacore/textures.h"
+#include "kaacore/threading.h"
 #include "kaacore/utils.h"
 
 #include "kaacore/fonts.h"
@@ -18,6 +25,9 @@
 namespace kaacore {
 
 ResourcesRegistry<std::string, FontData> _fonts_registry;
+// counted across all fonts, reset when pushed to statistics
+std::atomic<size_t> _text_layout_cache_frame_hits = 0;
+std::atomic<size_t> _text_layout_cache_frame_misses = 0;
 
 // SDF rasterization helper struct
 struct GlyphSDF {
@@ -28,12 +38,12 @@ struct GlyphSDF {
     std::unique_ptr<unsigned char[], std::function<void(unsigned char*)>> data;
     BitmapView<> bitmap_view;
 
-    GlyphSDF(
-        const stbtt_fontinfo& font_info, const UnicodeCodepoint codepoint,
-        const double scale
-    )
+    GlyphSDF(const UnicodeCodepoint codepoint, const double scale)
         : codepoint(codepoint), data(nullptr), dimensions({0, 0}),
           offset({0, 0}), scale(scale)
+    {}
+
+    void rasterize(const stbtt_fontinfo& font_info)
     {
         auto raw_data = stbtt_GetCodepointSDF(
             &font_info, scale, codepoint, font_sdf_padding, font_sdf_edge_value,
@@ -51,6 +61,74 @@ struct GlyphSDF {
     operator bool() const { return this->data != nullptr; }
 };
 
+struct _FontDynamicAtlas {
+    ResourceReference<UpdatableTexture> texture;
+    stbrp_context pack_context;
+    std::vector<stbrp_node> pack_nodes;
+};
+
+std::vector<UnicodeCodepoint>
+decode_utf8(const std::string& text)
+{
+    std::vector<UnicodeCodepoint> codepoints;
+    codepoints.reserve(text.size());
+
+    size_t i = 0;
+    while (i < text.size()) {
+        const uint8_t lead = text[i];
+        UnicodeCodepoint codepoint;
+        size_t length;
+        if (lead < 0x80) {
+            codepoint = lead;
+            length = 1;
+        } else if ((lead & 0xE0) == 0xC0) {
+            codepoint = lead & 0x1F;
+            length = 2;
+        } else if ((lead & 0xF0) == 0xE0) {
+            codepoint = lead & 0x0F;
+            length = 3;
+        } else if ((lead & 0xF8) == 0xF0) {
+            codepoint = lead & 0x07;
+            length = 4;
+        } else {
+            codepoints.push_back(unicode_replacement_character);
+            i++;
+            continue;
+        }
+
+        if (i + length > text.size()) {
+            codepoints.push_back(unicode_replacement_character);
+            break;
+        }
+
+        bool is_valid = true;
+        for (size_t j = 1; j < length; j++) {
+            const uint8_t continuation = text[i + j];
+            if ((continuation & 0xC0) != 0x80) {
+                is_valid = false;
+                break;
+            }
+            codepoint = (codepoint << 6) | (continuation & 0x3F);
+        }
+        // reject overlong encodings, surrogates and values out of range
+        constexpr UnicodeCodepoint min_codepoint_for_length[] = {
+            0, 0, 0x80, 0x800, 0x10000
+        };
+        if (not is_valid or codepoint < min_codepoint_for_length[length] or
+            codepoint > 0x10FFFF or
+            (codepoint >= 0xD800 and codepoint <= 0xDFFF)) {
+            codepoints.push_back(unicode_replacement_character);
+            i++;
+            continue;
+        }
+
+        codepoints.push_back(codepoint);
+        i += length;
+    }
+
+    return codepoints;
+}
+
 void
 initialize_fonts()
 {
@@ -71,26 +149,76 @@ uninitialize_fonts()
     }
 }
 
+void
+push_fonts_statistics()
+{
+    auto& stats_manager = get_global_statistics_manager();
+    static const auto hits_stat =
+        stats_manager.register_stat("fonts.text_layout_cache_hits:count");
+    static const auto misses_stat =
+        stats_manager.register_stat("fonts.text_layout_cache_misses:count");
+    stats_manager.push_value(
+        hits_stat, _text_layout_cache_frame_hits.exchange(0)
+    );
+    stats_manager.push_value(
+        misses_stat, _text_layout_cache_frame_misses.exchange(0)
+    );
+}
+
 std::vector<GlyphSDF>
 _rasterize_sdf_bitmaps(
     const stbtt_fontinfo& font_info, const double font_baking_scale,
-    const UnicodeCodepoint first_glyph_index, const size_t glyphs_count
+    const std::vector<UnicodeCodepoint>& codepoints
 )
 {
     std::vector<GlyphSDF> sdfs;
+    sdfs.reserve(codepoints.size());
+    for (const auto codepoint : codepoints) {
+        sdfs.emplace_back(codepoint, font_baking_scale);
+    }
 
-    for (UnicodeCodepoint codepoint = first_glyph_index;
-         codepoint < (first_glyph_index + glyphs_count); codepoint++) {
-        auto& sdf = sdfs.emplace_back(font_info, codepoint, font_baking_scale);
+    // every glyph is rasterized into its own slot, so the result
+    // (and packing order) doesn't depend on threads scheduling
+    get_worker_pool().parallel_for(
+        sdfs.size(), [&sdfs, &font_info](const size_t index) {
+            sdfs[index].rasterize(font_info);
+        }
+    );
+
+    for (const auto& sdf : sdfs) {
         KAACORE_LOG_TRACE(
             "Generated SDF glyph for character: #{}, dimensions: ({}, {}), "
             "offset: ({}, {})",
-            codepoint, sdf.dimensions.x, sdf.dimensions.y, sdf.offset.x,
+            sdf.codepoint, sdf.dimensions.x, sdf.dimensions.y, sdf.offset.x,
             sdf.offset.y
         );
     }
 
-    return std::move(sdfs);
+    return sdfs;
+}
+
+stbtt_packedchar
+_make_glyph_data(
+    const stbtt_fontinfo& font_info, const GlyphSDF& sdf,
+    const glm::ivec2 position, const glm::ivec2 size
+)
+{
+    int horizontal_advance, left_side_bearing;
+    stbtt_GetCodepointHMetrics(
+        &font_info, sdf.codepoint, &horizontal_advance, &left_side_bearing
+    );
+
+    stbtt_packedchar glyph_data;
+    glyph_data.x0 = position.x;
+    glyph_data.y0 = position.y;
+    glyph_data.x1 = position.x + size.x;
+    glyph_data.y1 = position.y + size.y;
+    glyph_data.xoff = sdf.offset.x;
+    glyph_data.yoff = sdf.offset.y;
+    glyph_data.xoff2 = sdf.offset.x + size.x;
+    glyph_data.yoff2 = sdf.offset.y + size.y;
+    glyph_data.xadvance = horizontal_advance * sdf.scale;
+    return glyph_data;
 }
 
 std::pair<bimg::ImageContainer*, BakedFontData>
@@ -132,23 +260,9 @@ _pack_sdf_glyphs(
         auto& rect = rects[i];
         auto& sdf = sdfs[i];
 
-        int horizontal_advance, left_side_bearing;
-        stbtt_GetCodepointHMetrics(
-            &font_info, sdf.codepoint, &horizontal_advance, &left_side_bearing
-        );
-
-        stbtt_packedchar glyph_data;
-        glyph_data.x0 = rect.x;
-        glyph_data.y0 = rect.y;
-        glyph_data.x1 = rect.x + rect.w;
-        glyph_data.y1 = rect.y + rect.h;
-        glyph_data.xoff = sdf.offset.x;
-        glyph_data.yoff = sdf.offset.y;
-        glyph_data.xoff2 = sdf.offset.x + rect.w;
-        glyph_data.yoff2 = sdf.offset.y + rect.h;
-        glyph_data.xadvance = horizontal_advance * sdf.scale;
-
-        baked_font_data.push_back(glyph_data);
+        baked_font_data.push_back(_make_glyph_data(
+            font_info, sdf, {rect.x, rect.y}, {rect.w, rect.h}
+        ));
 
         if (sdf) {
             atlas_bitmap.blit(sdf.bitmap_view, {rect.x, rect.y});
@@ -163,8 +277,11 @@ _pack_sdf_glyphs(
     return {baked_font_image, baked_font_data};
 }
 
-std::tuple<bimg::ImageContainer*, BakedFontData, FontMetrics>
-bake_font_texture(const uint8_t* font_file_content, const size_t size)
+void
+_init_font_info(
+    stbtt_fontinfo& font_info, const uint8_t* font_file_content,
+    const size_t size
+)
 {
     if (memcmp(
             font_file_content, "\x00\x01\x00\x00\x00", size >= 5 ? 5 : size
@@ -175,23 +292,25 @@ bake_font_texture(const uint8_t* font_file_content, const size_t size)
     }
 
     KAACORE_LOG_DEBUG("Loading font data.");
-    stbtt_fontinfo font_info;
     font_info.userdata = nullptr;
     stbtt_InitFont(
         &font_info, font_file_content,
         stbtt_GetFontOffsetForIndex(font_file_content, 0)
     );
+}
 
-    const double font_baking_scale =
-        stbtt_ScaleForPixelHeight(&font_info, font_baker_pixel_height);
+BakedFontAtlas
+bake_font_texture(
+    const stbtt_fontinfo& font_info, const double font_baking_scale,
+    const std::vector<UnicodeCodepoint>& codepoints
+)
+{
     KAACORE_LOG_DEBUG(
         "Calculated font baking scale: {:.4f}", font_baking_scale
     );
 
-    auto sdf_bitmaps = _rasterize_sdf_bitmaps(
-        font_info, font_baking_scale, font_baker_first_glyph,
-        font_baker_glyphs_count
-    );
+    auto sdf_bitmaps =
+        _rasterize_sdf_bitmaps(font_info, font_baking_scale, codepoints);
     auto [image_container, baked_font_data] =
         _pack_sdf_glyphs(font_info, sdf_bitmaps);
 
@@ -209,14 +328,6 @@ bake_font_texture(const uint8_t* font_file_content, const size_t size)
     return {image_container, baked_font_data, font_metrics};
 }
 
-std::tuple<bimg::ImageContainer*, BakedFontData, FontMetrics>
-bake_font_texture(const File& font_file)
-{
-    return bake_font_texture(
-        font_file.content.data(), font_file.content.size()
-    );
-}
-
 FontMetrics
 FontMetrics::scale_for_pixel_height(const double font_pixel_height) const
 {
@@ -233,6 +344,27 @@ FontMetrics::height() const
     return (this->ascent - this->descent);
 }
 
+bool
+TextLayoutParams::operator==(const TextLayoutParams& other) const
+{
+    return (
+        this->content == other.content and
+        this->font_size == other.font_size and
+        this->line_height == other.line_height and
+        this->line_width == other.line_width and
+        this->first_line_indent == other.first_line_indent
+    );
+}
+
+size_t
+TextLayoutParamsHash::operator()(const TextLayoutParams& params) const
+{
+    return hash_combined_seeded(
+        0, params.content, params.font_size, params.line_height,
+        params.line_width, params.first_line_indent
+    );
+}
+
 FontRenderGlyph::FontRenderGlyph(
     UnicodeCodepoint codepoint, stbtt_packedchar glyph_data,
     double scale_factor, const glm::dvec2 inv_texture_size
@@ -269,6 +401,57 @@ FontRenderGlyph::has_size() const
     return this->size.x > 0 and this->size.y > 0;
 }
 
+BoundingBox<double>
+FontRenderGlyph::bounding_box(const FontMetrics font_metrics) const
+{
+    return {
+        this->position.x, this->position.y - font_metrics.ascent,
+        this->position.x + this->advance,
+        this->position.y - font_metrics.descent
+    };
+}
+
+std::array<StandardVertexData, 4>
+FontRenderGlyph::quad_vertices() const
+{
+    const glm::dvec2 top_left = this->position + this->offset;
+    const glm::dvec2 bottom_right = top_left + this->size;
+    return {
+        // Left-top vertex
+        StandardVertexData::xy_uv(
+            top_left.x, top_left.y, this->texture_uv0.x, this->texture_uv0.y
+        ),
+        // Right-top vertex
+        StandardVertexData::xy_uv(
+            bottom_right.x, top_left.y, this->texture_uv1.x,
+            this->texture_uv0.y
+        ),
+        // Left-bottom vertex
+        StandardVertexData::xy_uv(
+            top_left.x, bottom_right.y, this->texture_uv0.x,
+            this->texture_uv1.y
+        ),
+        // Right-bottom vertex
+        StandardVertexData::xy_uv(
+            bottom_right.x, bottom_right.y, this->texture_uv1.x,
+            this->texture_uv1.y
+        )
+    };
+}
+
+inline void
+_append_quad_indices(
+    std::vector<VertexIndex>& indices, const VertexIndex first_vertex
+)
+{
+    indices.push_back(first_vertex + 0);
+    indices.push_back(first_vertex + 2);
+    indices.push_back(first_vertex + 1);
+    indices.push_back(first_vertex + 1);
+    indices.push_back(first_vertex + 2);
+    indices.push_back(first_vertex + 3);
+}
+
 void
 FontRenderGlyph::arrange_glyphs(
     std::vector<FontRenderGlyph>& render_glyphs, const double indent,
@@ -279,13 +462,13 @@ FontRenderGlyph::arrange_glyphs(
     std::vector<FontRenderGlyph>::iterator word_start = render_glyphs.begin();
 
     for (auto it = word_start; it != render_glyphs.end(); it++) {
+        it->position = current_pos;
         if (it->codepoint == static_cast<UnicodeCodepoint>(' ')) {
             word_start = it + 1;
             if (current_pos.x == 0.) {
                 continue;
             }
         }
-        it->position = current_pos;
 
         if (it->codepoint == static_cast<UnicodeCodepoint>('\n')) {
             word_start = it + 1;
@@ -330,87 +513,91 @@ FontRenderGlyph::make_shape(
     indices.reserve(glyphs_count * 6);
 
     for (const FontRenderGlyph& rg : render_glyphs) {
-        BoundingBox<double> rg_bounding_box{
-            rg.position.x, rg.position.y - font_metrics.ascent,
-            rg.position.x + rg.advance, rg.position.y - font_metrics.descent
-        };
-        bounding_box = rg_bounding_box.merge(bounding_box);
-
+        bounding_box = rg.bounding_box(font_metrics).merge(bounding_box);
         if (not rg.has_size()) {
             continue;
         }
-        auto vertices_count = vertices.size();
-
-        vertices.push_back(
-            // Left-top vertex
-            StandardVertexData::xy_uv(
-                rg.position.x + rg.offset.x, rg.position.y + rg.offset.y,
-                rg.texture_uv0.x, rg.texture_uv0.y
-            )
-        );
-        vertices.push_back(
-            // Right-top vertex
-            StandardVertexData::xy_uv(
-                rg.position.x + rg.offset.x + rg.size.x,
-                rg.position.y + rg.offset.y, rg.texture_uv1.x, rg.texture_uv0.y
-            )
-        );
-        vertices.push_back(
-            // Left-bottom vertex
-            StandardVertexData::xy_uv(
-                rg.position.x + rg.offset.x,
-                rg.position.y + rg.offset.y + rg.size.y, rg.texture_uv0.x,
-                rg.texture_uv1.y
-            )
-        );
-        vertices.push_back(
-            // Right-bottom vertex
-            StandardVertexData::xy_uv(
-                rg.position.x + rg.offset.x + rg.size.x,
-                rg.position.y + rg.offset.y + rg.size.y, rg.texture_uv1.x,
-                rg.texture_uv1.y
-            )
-        );
-
-        indices.push_back(vertices_count + 0);
-        indices.push_back(vertices_count + 2);
-        indices.push_back(vertices_count + 1);
-        indices.push_back(vertices_count + 1);
-        indices.push_back(vertices_count + 2);
-        indices.push_back(vertices_count + 3);
+        _append_quad_indices(indices, vertices.size());
+        const auto quad = rg.quad_vertices();
+        vertices.insert(vertices.end(), quad.begin(), quad.end());
     }
 
-    return Shape::Freeform(indices, vertices, bounding_box);
+    // text bounds are always a rectangle, so there is no need
+    // for polygon classification done by Shape constructor
+    Shape shape;
+    shape.type = ShapeType::freeform;
+    shape.radius = 0.;
+    shape.indices = std::move(indices);
+    shape.vertices = std::move(vertices);
+    shape.vertices_bbox = bounding_box;
+    shape.bounding_points = {
+        {bounding_box.min_x, bounding_box.min_y},
+        {bounding_box.max_x, bounding_box.min_y},
+        {bounding_box.max_x, bounding_box.max_y},
+        {bounding_box.min_x, bounding_box.max_y}
+    };
+    return shape;
 }
 
 FontData::FontData(const std::string& path) : path(path)
 {
-    File file(this->path);
-    auto [baked_font_image, baked_font_data, font_metrics] =
-        bake_font_texture(file);
-    this->baked_texture = MemoryTexture::create(baked_font_image);
-    this->baked_font = std::move(baked_font_data);
-    this->font_metrics = font_metrics;
+    // font stays mapped, stb_truetype reads glyphs directly from it
+    this->_font_source = map_file(this->path);
+    this->_bake();
 
     if (is_engine_initialized()) {
         this->_initialize();
     }
 }
 
-FontData::FontData(
-    const ResourceReference<Texture> baked_texture,
-    const BakedFontData baked_font, const FontMetrics font_metrics
-)
+FontData::FontData(const Memory& font_source) : _font_source(font_source)
 {
-    this->baked_texture = baked_texture;
-    this->baked_font = std::move(baked_font);
-    this->font_metrics = font_metrics;
+    this->_bake();
 
     if (is_engine_initialized()) {
         this->_initialize();
     }
 }
 
+void
+FontData::_bake()
+{
+    // font info references font source, so it must be kept alive
+    _init_font_info(
+        this->_font_info,
+        reinterpret_cast<const uint8_t*>(this->_font_source.get()),
+        this->_font_source.size()
+    );
+    this->_font_baking_scale =
+        stbtt_ScaleForPixelHeight(&this->_font_info, font_baker_pixel_height);
+
+    const auto cache_directory = get_font_cache_directory();
+    std::optional<BakedFontAtlas> atlas;
+    uint64_t cache_key = 0;
+    if (not cache_directory.empty()) {
+        cache_key = calculate_font_cache_key(
+            this->_font_source.get(), this->_font_source.size()
+        );
+        atlas = load_font_cache(cache_directory, cache_key);
+    }
+    if (not atlas) {
+        std::vector<UnicodeCodepoint> codepoints(font_baker_glyphs_count);
+        std::iota(codepoints.begin(), codepoints.end(), font_baker_first_glyph);
+        atlas = bake_font_texture(
+            this->_font_info, this->_font_baking_scale, codepoints
+        );
+        if (not cache_directory.empty()) {
+            store_font_cache(cache_directory, cache_key, *atlas);
+        }
+    }
+
+    auto& [baked_font_image, baked_font_data, font_metrics] = *atlas;
+    this->_initial_texture = MemoryTexture::create(baked_font_image);
+    this->baked_texture = this->_initial_texture;
+    this->baked_font = std::move(baked_font_data);
+    this->font_metrics = font_metrics;
+}
+
 ResourceReference<FontData>
 FontData::load(const std::string& path)
 {
@@ -427,13 +614,7 @@ FontData::load(const std::string& path)
 ResourceReference<FontData>
 FontData::load_from_memory(const Memory& memory)
 {
-    auto raw_memory = reinterpret_cast<const uint8_t*>(memory.get());
-    auto [baked_font_texture, baked_font_data, font_metrics] =
-        bake_font_texture(raw_memory, memory.size());
-
-    return std::shared_ptr<FontData>(new FontData(
-        MemoryTexture::create(baked_font_texture), baked_font_data, font_metrics
-    ));
+    return std::shared_ptr<FontData>(new FontData(memory));
 }
 
 FontData::~FontData()
@@ -443,55 +624,308 @@ FontData::~FontData()
     }
 }
 
+size_t
+FontData::dynamic_glyphs_count() const
+{
+    return this->_dynamic_glyphs.size();
+}
+
+const stbtt_packedchar*
+FontData::_find_glyph(const UnicodeCodepoint codepoint) const
+{
+    if (codepoint >= font_baker_first_glyph and
+        codepoint < font_baker_first_glyph + font_baker_glyphs_count) {
+        return &this->baked_font[codepoint - font_baker_first_glyph];
+    }
+
+    const auto it = this->_dynamic_glyphs.find(codepoint);
+    if (it != this->_dynamic_glyphs.end()) {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+bool
+FontData::_create_dynamic_atlas()
+{
+    const auto& initial_image = this->_initial_texture.get()->image_container;
+    const glm::uvec2 initial_size = {
+        initial_image->m_width, initial_image->m_height
+    };
+    if (initial_size.x > font_atlas_page_size or
+        initial_size.y >= font_atlas_page_size) {
+        KAACORE_LOG_WARN("Baked font texture is too big to be extended.");
+        return false;
+    }
+
+    auto atlas = std::make_unique<_FontDynamicAtlas>();
+    atlas->pack_nodes.resize(font_atlas_page_size);
+    stbrp_init_target(
+        &atlas->pack_context, font_atlas_page_size, font_atlas_page_size,
+        atlas->pack_nodes.data(), atlas->pack_nodes.size()
+    );
+    // reserve area occupied by glyphs baked at load time,
+    // so their texture coordinates remain valid
+    stbrp_rect initial_rect{};
+    initial_rect.w = initial_size.x;
+    initial_rect.h = initial_size.y;
+    stbrp_pack_rects(&atlas->pack_context, &initial_rect, 1);
+    KAACORE_ASSERT(
+        initial_rect.was_packed and initial_rect.x == 0 and
+            initial_rect.y == 0,
+        "Failed to reserve initial font atlas area."
+    );
+
+    Bitmap atlas_bitmap{{font_atlas_page_size, font_atlas_page_size}};
+    atlas_bitmap.blit(
+        BitmapView{
+            reinterpret_cast<uint8_t*>(initial_image->m_data), initial_size
+        },
+        {0, 0}
+    );
+    atlas->texture = UpdatableTexture::create(load_raw_image(
+        bimg::TextureFormat::Enum::R8, font_atlas_page_size,
+        font_atlas_page_size, atlas_bitmap.container
+    ));
+
+    // text shapes generated so far keep using the initial texture
+    this->baked_texture = atlas->texture;
+    this->_dynamic_atlas = std::move(atlas);
+    // new layouts should use the atlas, so the initial texture
+    // can be released once no node uses it
+    this->_text_layouts.clear();
+    this->_text_layouts_index.clear();
+    KAACORE_LOG_DEBUG(
+        "Created dynamic font atlas of size: ({}, {})", font_atlas_page_size,
+        font_atlas_page_size
+    );
+    return true;
+}
+
+void
+FontData::_bake_missing_glyphs(const std::vector<UnicodeCodepoint>& codepoints)
+{
+    std::vector<UnicodeCodepoint> missing_codepoints;
+    for (const auto codepoint : codepoints) {
+        if (codepoint == static_cast<UnicodeCodepoint>('\n') or
+            this->_find_glyph(codepoint) or
+            this->_unavailable_glyphs.count(codepoint) or
+            std::find(
+                missing_codepoints.begin(), missing_codepoints.end(), codepoint
+            ) != missing_codepoints.end()) {
+            continue;
+        }
+        if (stbtt_FindGlyphIndex(&this->_font_info, codepoint) == 0) {
+            KAACORE_LOG_WARN("Unhandled font character: #{}", codepoint);
+            this->_unavailable_glyphs.insert(codepoint);
+            continue;
+        }
+        missing_codepoints.push_back(codepoint);
+    }
+
+    if (missing_codepoints.empty()) {
+        return;
+    }
+    if (not this->_dynamic_atlas and not this->_create_dynamic_atlas()) {
+        this->_unavailable_glyphs.insert(
+            missing_codepoints.begin(), missing_codepoints.end()
+        );
+        return;
+    }
+
+    auto& atlas = *this->_dynamic_atlas;
+    const auto sdfs = _rasterize_sdf_bitmaps(
+        this->_font_info, this->_font_baking_scale, missing_codepoints
+    );
+    for (const auto& sdf : sdfs) {
+        const auto codepoint = sdf.codepoint;
+        // add 1px of spacing between glyphs
+        stbrp_rect rect{};
+        rect.w = sdf.dimensions.x + 1;
+        rect.h = sdf.dimensions.y + 1;
+        stbrp_pack_rects(&atlas.pack_context, &rect, 1);
+        if (not rect.was_packed) {
+            KAACORE_LOG_WARN(
+                "Font atlas is full, can't bake character: #{}", codepoint
+            );
+            this->_unavailable_glyphs.insert(codepoint);
+            continue;
+        }
+
+        KAACORE_LOG_TRACE(
+            "Baked SDF glyph for character: #{}, position: ({}, {}), "
+            "dimensions: ({}, {})",
+            codepoint, rect.x, rect.y, sdf.dimensions.x, sdf.dimensions.y
+        );
+        if (sdf) {
+            atlas.texture.get()->update(
+                glm::uvec2(rect.x, rect.y), glm::uvec2(sdf.dimensions),
+                sdf.data.get()
+            );
+        }
+        this->_dynamic_glyphs.emplace(
+            codepoint, _make_glyph_data(
+                           this->_font_info, sdf, {rect.x, rect.y},
+                           sdf.dimensions
+                       )
+        );
+    }
+}
+
 std::vector<FontRenderGlyph>
 FontData::generate_render_glyphs(
     const std::string& text, const double scale_factor
 )
 {
     std::vector<FontRenderGlyph> render_glyphs;
+    this->update_render_glyphs(
+        decode_utf8(text), scale_factor, render_glyphs, 0
+    );
+    return render_glyphs;
+}
+
+size_t
+FontData::update_render_glyphs(
+    const std::vector<UnicodeCodepoint>& codepoints, const double scale_factor,
+    std::vector<FontRenderGlyph>& render_glyphs, size_t first_changed_index
+)
+{
+    // baking may replace atlas texture, so it must happen
+    // before texture dimensions are read
+    const Texture* previous_texture = this->baked_texture.get();
+    this->_bake_missing_glyphs(codepoints);
+    if (this->baked_texture.get() != previous_texture) {
+        first_changed_index = 0;
+    }
+    first_changed_index = std::min(
+        {first_changed_index, codepoints.size(), render_glyphs.size()}
+    );
+
+    render_glyphs.erase(
+        render_glyphs.begin() + first_changed_index, render_glyphs.end()
+    );
+    render_glyphs.reserve(codepoints.size());
     const glm::dvec2 inv_texture_size = {
         1. / this->baked_texture->get_dimensions().x,
         1. / this->baked_texture->get_dimensions().y
     };
 
-    for (const auto ch : text) {
-        UnicodeCodepoint ch_value;
-        if (ch == '\n') {
-            ch_value =
-                static_cast<UnicodeCodepoint>(' ') - font_baker_first_glyph;
-        } else {
-            ch_value =
-                static_cast<UnicodeCodepoint>(ch) - font_baker_first_glyph;
-        }
-
-        if (ch_value > font_baker_glyphs_count) {
-            KAACORE_LOG_WARN("Unhadled font character: {}", ch_value);
-            ch_value =
-                static_cast<UnicodeCodepoint>('?') - font_baker_first_glyph;
+    for (size_t i = first_changed_index; i < codepoints.size(); i++) {
+        const auto codepoint = codepoints[i];
+        const stbtt_packedchar* glyph_data;
+        if (codepoint == static_cast<UnicodeCodepoint>('\n')) {
+            glyph_data = this->_find_glyph(' ');
+        } else if (not(glyph_data = this->_find_glyph(codepoint))) {
+            glyph_data = this->_find_glyph(font_fallback_glyph);
         }
-
-        auto glyph_data = this->baked_font.at(ch_value);
+        KAACORE_ASSERT(glyph_data, "Invalid internal font state.");
 
         if (not render_glyphs.empty()) {
             render_glyphs.emplace_back(
-                ch, glyph_data, scale_factor, inv_texture_size,
+                codepoint, *glyph_data, scale_factor, inv_texture_size,
                 render_glyphs.back()
             );
         } else {
             render_glyphs.emplace_back(
-                ch, glyph_data, scale_factor, inv_texture_size
+                codepoint, *glyph_data, scale_factor, inv_texture_size
             );
         }
     }
 
-    return render_glyphs;
+    return first_changed_index;
+}
+
+std::shared_ptr<const TextLayout>
+FontData::get_text_layout(
+    const TextLayoutParams& params, const TextLayout* previous_layout
+)
+{
+    auto it = this->_text_layouts_index.find(params);
+    if (it != this->_text_layouts_index.end()) {
+        this->_text_layout_cache_hits++;
+        _text_layout_cache_frame_hits++;
+        this->_text_layouts.splice(
+            this->_text_layouts.begin(), this->_text_layouts, it->second
+        );
+        return *it->second;
+    }
+
+    this->_text_layout_cache_misses++;
+    _text_layout_cache_frame_misses++;
+    auto layout = this->_make_text_layout(params, previous_layout);
+    this->_text_layouts.push_front(layout);
+    this->_text_layouts_index.emplace(params, this->_text_layouts.begin());
+    if (this->_text_layouts.size() > text_layout_cache_capacity) {
+        this->_text_layouts_index.erase(this->_text_layouts.back()->params);
+        this->_text_layouts.pop_back();
+    }
+    return layout;
+}
+
+std::shared_ptr<const TextLayout>
+FontData::_make_text_layout(
+    const TextLayoutParams& params, const TextLayout* previous_layout
+)
+{
+    auto layout = std::make_shared<TextLayout>();
+    layout->params = params;
+    layout->codepoints = decode_utf8(params.content);
+    const double scale_factor = params.font_size / font_baker_pixel_height;
+
+    // glyphs are regenerated only from first changed character,
+    // as long as scale and atlas texture stay the same
+    size_t first_changed_index = 0;
+    if (previous_layout and
+        previous_layout->params.font_size == params.font_size and
+        previous_layout->texture.get() == this->baked_texture.get()) {
+        first_changed_index =
+            std::mismatch(
+                layout->codepoints.begin(), layout->codepoints.end(),
+                previous_layout->codepoints.begin(),
+                previous_layout->codepoints.end()
+            ).first -
+            layout->codepoints.begin();
+        layout->render_glyphs.assign(
+            previous_layout->render_glyphs.begin(),
+            previous_layout->render_glyphs.begin() + first_changed_index
+        );
+    }
+    this->update_render_glyphs(
+        layout->codepoints, scale_factor, layout->render_glyphs,
+        first_changed_index
+    );
+    layout->texture = this->baked_texture;
+
+    FontRenderGlyph::arrange_glyphs(
+        layout->render_glyphs, params.first_line_indent, params.line_height,
+        params.line_width
+    );
+    layout->shape = FontRenderGlyph::make_shape(
+        layout->render_glyphs,
+        this->font_metrics.scale_for_pixel_height(params.font_size)
+    );
+    return layout;
+}
+
+TextLayoutCacheStats
+FontData::text_layout_cache_stats() const
+{
+    return {
+        this->_text_layout_cache_hits, this->_text_layout_cache_misses,
+        this->_text_layouts.size()
+    };
 }
 
 void
 FontData::_initialize()
 {
-    if (not this->baked_texture.res_ptr.get()->is_initialized) {
-        this->baked_texture.res_ptr.get()->_initialize();
+    // initial texture may be still used by existing text shapes
+    for (Texture* texture :
+         {static_cast<Texture*>(this->_initial_texture.get()),
+          this->baked_texture.get()}) {
+        if (not texture->is_initialized) {
+            texture->_initialize();
+        }
     }
     this->is_initialized = true;
 }
@@ -499,8 +933,12 @@ FontData::_initialize()
 void
 FontData::_uninitialize()
 {
-    if (this->baked_texture.res_ptr.get()->is_initialized) {
-        this->baked_texture.res_ptr.get()->_uninitialize();
+    for (Texture* texture :
+         {static_cast<Texture*>(this->_initial_texture.get()),
+          this->baked_texture.get()}) {
+        if (texture->is_initialized) {
+            texture->_uninitialize();
+        }
     }
     this->is_initialized = false;
 }
@@ -516,6 +954,12 @@ Font::load(const std::string& font_filepath)
     return Font(FontData::load(font_filepath));
 }
 
+ResourceReference<FontData>
+Font::font_data() const
+{
+    return this->_font_data;
+}
+
 bool
 Font::operator==(const Font& other)
 {
@@ -549,24 +993,79 @@ void
 TextNode::_update_shape()
 {
     KAACORE_ASSERT(this->_font._font_data, "Invalid internal font state.");
-    const double scale_factor = this->_font_size / font_baker_pixel_height;
-    const auto scaled_metrics =
-        this->_font._font_data->metrics().scale_for_pixel_height(
-            this->_font_size
-        );
-    this->_render_glyphs = this->_font._font_data->generate_render_glyphs(
-        this->_content, scale_factor
-    );
-    FontRenderGlyph::arrange_glyphs(
-        this->_render_glyphs, this->_first_line_indent,
-        this->_font_size * this->_interline_spacing, this->_line_width
+    FontData* font_data = this->_font._font_data.get();
+    auto layout = font_data->get_text_layout(
+        {this->_content, this->_font_size,
+         this->_font_size * this->_interline_spacing, this->_line_width,
+         this->_first_line_indent},
+        this->_layout.get()
     );
 
     Node* node = container_node(this);
-    node->sprite(this->_font._font_data->baked_texture);
-    node->shape(
-        FontRenderGlyph::make_shape(this->_render_glyphs, scaled_metrics)
-    );
+    node->sprite(layout->texture);
+    this->_update_node_shape(node, layout->shape);
+    this->_layout = std::move(layout);
+}
+
+void
+TextNode::_update_node_shape(Node* node, const Shape& layout_shape)
+{
+    if (not layout_shape) {
+        this->_quads_count = 0;
+        node->shape(Shape{});
+        return;
+    }
+
+    // layout shape is shared, so it's copied into node's shape
+    // in place, only quads of glyphs that actually changed are rewritten
+    Shape& shape = node->_shape;
+    if (shape.type != ShapeType::freeform or
+        shape.vertices.size() != this->_quads_count * 4 or
+        shape.indices.size() != this->_quads_count * 6) {
+        shape.vertices.clear();
+        shape.indices.clear();
+    }
+    bool changed = shape.type != ShapeType::freeform;
+    shape.type = ShapeType::freeform;
+    shape.points.clear();
+    shape.radius = 0.;
+
+    const size_t quads_count = layout_shape.vertices.size() / 4;
+    for (size_t i = 0; i < quads_count; i++) {
+        const size_t offset = i * 4;
+        const auto quad_begin = layout_shape.vertices.begin() + offset;
+        const auto quad_end = quad_begin + 4;
+        if (offset < shape.vertices.size()) {
+            auto vertices_it = shape.vertices.begin() + offset;
+            if (not std::equal(quad_begin, quad_end, vertices_it)) {
+                std::copy(quad_begin, quad_end, vertices_it);
+                changed = true;
+            }
+        } else {
+            shape.vertices.insert(shape.vertices.end(), quad_begin, quad_end);
+            _append_quad_indices(shape.indices, offset);
+            changed = true;
+        }
+    }
+    if (quads_count < this->_quads_count) {
+        shape.vertices.resize(quads_count * 4);
+        shape.indices.resize(quads_count * 6);
+        changed = true;
+    }
+    this->_quads_count = quads_count;
+
+    if (not(shape.vertices_bbox == layout_shape.vertices_bbox)) {
+        shape.vertices_bbox = layout_shape.vertices_bbox;
+        shape.bounding_points = layout_shape.bounding_points;
+        changed = true;
+    }
+
+    node->_auto_shape = false;
+    if (changed) {
+        node->set_dirty_flags(
+            Node::DIRTY_DRAW_VERTICES | Node::DIRTY_SPATIAL_INDEX
+        );
+    }
 }
 
 std::string
@@ -578,6 +1077,9 @@ TextNode::content() const
 void
 TextNode::content(const std::string& content)
 {
+    if (this->_layout and content == this->_content) {
+        return;
+    }
     this->_content = content;
     this->_update_shape();
 }
@@ -591,6 +1093,9 @@ TextNode::font_size() const
 void
 TextNode::font_size(const double font_size)
 {
+    if (this->_layout and font_size == this->_font_size) {
+        return;
+    }
     this->_font_size = font_size;
     this->_update_shape();
 }
@@ -604,6 +1109,9 @@ TextNode::line_width() const
 void
 TextNode::line_width(const double line_width)
 {
+    if (this->_layout and line_width == this->_line_width) {
+        return;
+    }
     this->_line_width = line_width;
     this->_update_shape();
 }
@@ -617,6 +1125,9 @@ TextNode::interline_spacing() const
 void
 TextNode::interline_spacing(const double interline_spacing)
 {
+    if (this->_layout and interline_spacing == this->_interline_spacing) {
+        return;
+    }
     this->_interline_spacing = interline_spacing;
     this->_update_shape();
 }
@@ -630,6 +1141,9 @@ TextNode::first_line_indent() const
 void
 TextNode::first_line_indent(const double first_line_indent)
 {
+    if (this->_layout and first_line_indent == this->_first_line_indent) {
+        return;
+    }
     this->_first_line_indent = first_line_indent;
     this->_update_shape();
 }
@@ -643,6 +1157,9 @@ TextNode::font() const
 void
 TextNode::font(const Font& font)
 {
+    if (this->_layout and this->_font == font) {
+        return;
+    }
     this->_font = font;
     this->_update_shape();
 }
@@ -155,7 +155,7 @@ ShadingContext::_name_in_registry(const std::string& name) const
 
 void
 ShadingContext::_set_uniform_texture(
-    const std::string& name, const Texture* texture, const uint8_t stage,
+    const std::string& name, Texture* texture, const uint8_t stage,
     const uint32_t flags
 )
 {
@@ -90,6 +90,12 @@ Memory::reference(const std::byte* memory, std::size_t size)
     return Memory(memory, size);
 }
 
+Memory
+Memory::share(std::shared_ptr<std::byte> memory, std::size_t size)
+{
+    return Memory(std::move(memory), size);
+}
+
 void
 Memory::destroy()
 {
@@ -855,13 +855,13 @@ Node::origin_alignment(const Alignment alignment)
 NodeTransitionHandle
 Node::transition()
 {
-    return this->_transitions_manager.get(default_transition_name);
+    return this->_transitions_manager.get(default_transition_slot);
 }
 
 void
 Node::transition(const NodeTransitionHandle& transition)
 {
-    this->_transitions_manager.set(default_transition_name, transition);
+    this->_transitions_manager.set(default_transition_slot, transition);
 }
 
 Duration
@@ -1043,7 +1043,7 @@ Node::_update_hitboxes()
 {
     this->recursive_call_downstream([](Node* n) {
         if (n->_type == NodeType::hitbox) {
-            n->hitbox.update_physics_shape();
+            n->hitbox.update_physics_shape_transformation();
         }
         return n->_in_hitbox_chain;
     });
@@ -1,7 +1,9 @@
 #include <cmath>
 #include <type_traits>
+#include <vector>
 
 #include <chipmunk/chipmunk.h>
+#include <chipmunk/chipmunk_unsafe.h>
 
 #ifndef _MSC_VER
 extern "C"
@@ -16,12 +18,14 @@ extern "C"
 }
 #endif
 
+#include <glm/gtc/epsilon.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "kaacore/exceptions.h"
 #include "kaacore/geometry.h"
 #include "kaacore/log.h"
 #include "kaacore/nodes.h"
+#include "kaacore/tracing.h"
 #include "kaacore/utils.h"
 
 #include "kaacore/physics.h"
@@ -431,6 +435,7 @@ void
 SpaceNode::simulate(const HighPrecisionDuration dt)
 {
     ASSERT_VALID_SPACE_NODE(this);
+    KAACORE_TRACE_SCOPE("physics", "simulate");
     KAACORE_LOG_TRACE(
         "Simulating SpaceNode({}) physics, dt = {}", fmt::ptr(this), dt.count()
     );
@@ -1225,11 +1230,70 @@ HitboxNode::space() const
 
 void
 HitboxNode::update_physics_shape()
+{
+    Node* node = container_node(this);
+    this->_rebuild_physics_shape(
+        calculate_inherited_hitbox_transformation(node)
+    );
+}
+
+void
+HitboxNode::update_physics_shape_transformation()
+{
+    Node* node = container_node(this);
+    const auto transformation = calculate_inherited_hitbox_transformation(node);
+    const auto scale = transformation.decompose().scale;
+
+    auto space_node = this->space();
+    if (this->_cp_shape == nullptr or
+        glm::any(glm::epsilonNotEqual(scale, this->_cp_shape_scale, 1e-10)) or
+        (space_node and space_node->locked())) {
+        // radius of the shape depends on scale, everything else
+        // (offset, endpoints and vertices) can be updated in place
+        this->_rebuild_physics_shape(transformation);
+        return;
+    }
+
+    thread_local std::vector<cpVect> cp_points;
+    cp_points.clear();
+    for (const auto& pt : node->_shape.points) {
+        cp_points.push_back(convert_vector(pt | transformation));
+    }
+
+    KAACORE_LOG_TRACE(
+        "Updating hitbox node {} shape in place (cpShape: {})", fmt::ptr(node),
+        fmt::ptr(this->_cp_shape)
+    );
+    switch (node->_shape.type) {
+        case ShapeType::segment:
+            cpSegmentShapeSetEndpoints(
+                this->_cp_shape, cp_points[0], cp_points[1]
+            );
+            break;
+        case ShapeType::circle:
+            cpCircleShapeSetOffset(this->_cp_shape, cp_points[0]);
+            break;
+        case ShapeType::polygon:
+            cpPolyShapeSetVertsRaw(
+                this->_cp_shape, cp_points.size(), cp_points.data()
+            );
+            break;
+        default:
+            KAACORE_ASSERT(false, "Unsupported shape.");
+    }
+
+    if (space_node) {
+        cpSpaceReindexShape(space_node->_cp_space, this->_cp_shape);
+    }
+}
+
+void
+HitboxNode::_rebuild_physics_shape(const Transformation& transformation)
 {
     Node* node = container_node(this);
     cpShape* new_cp_shape;
-    auto transformation = calculate_inherited_hitbox_transformation(node);
     new_cp_shape = prepare_hitbox_shape(node->_shape, transformation).release();
+    this->_cp_shape_scale = transformation.decompose().scale;
     KAACORE_LOG_DEBUG(
         "Updating hitbox node {} shape (cpShape: {})", fmt::ptr(node),
         fmt::ptr(new_cp_shape)
@@ -1289,7 +1353,7 @@ HitboxNode::attach_to_simulation()
         this->_cp_shape != nullptr, "Invalid internal state of hitbox."
     );
     // we might need to adjust for parents' transformation
-    this->update_physics_shape();
+    this->update_physics_shape_transformation();
     Node* node = container_node(this);
     KAACORE_LOG_DEBUG(
         "Attaching hitbox node {} to simulation (body) (cpShape: {})",
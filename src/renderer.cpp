@@ -15,6 +15,7 @@
 #include "kaacore/scenes.h"
 #include "kaacore/statistics.h"
 #include "kaacore/textures.h"
+#include "kaacore/tracing.h"
 
 namespace kaacore {
 
@@ -362,31 +363,44 @@ void
 Renderer::push_statistics() const
 {
     auto& stats_manager = get_global_statistics_manager();
+    static const auto draw_calls_stat =
+        stats_manager.register_stat("bgfx.draw_calls:count");
+    static const auto textures_stat =
+        stats_manager.register_stat("bgfx.textures:memory");
+    static const auto transient_vb_stat =
+        stats_manager.register_stat("bgfx.transient_vb:memory");
+    static const auto transient_ib_stat =
+        stats_manager.register_stat("bgfx.transient_ib:memory");
+    static const auto cpu_frame_stat =
+        stats_manager.register_stat("bgfx.cpu_frame:time");
+    static const auto wait_submit_stat =
+        stats_manager.register_stat("bgfx.wait_submit:time");
+    static const auto wait_render_stat =
+        stats_manager.register_stat("bgfx.wait_render:time");
     auto* bgfx_stats = bgfx::getStats();
 
-    stats_manager.push_value("bgfx.draw_calls:count", bgfx_stats->numDraw);
+    stats_manager.push_value(draw_calls_stat, bgfx_stats->numDraw);
     stats_manager.push_value(
-        "bgfx.textures:memory",
-        float(bgfx_stats->textureMemoryUsed) / (1024. * 1024.)
+        textures_stat, float(bgfx_stats->textureMemoryUsed) / (1024. * 1024.)
     );
     stats_manager.push_value(
-        "bgfx.transient_vb:memory",
+        transient_vb_stat,
         float(bgfx_stats->transientVbUsed) / (1024. * 1024.)
     );
     stats_manager.push_value(
-        "bgfx.transient_ib:memory",
+        transient_ib_stat,
         float(bgfx_stats->transientIbUsed) / (1024. * 1024.)
     );
     stats_manager.push_value(
-        "bgfx.cpu_frame:time",
+        cpu_frame_stat,
         float(bgfx_stats->cpuTimeFrame) / bgfx_stats->cpuTimerFreq
     );
     stats_manager.push_value(
-        "bgfx.wait_submit:time",
+        wait_submit_stat,
         float(bgfx_stats->waitSubmit) / bgfx_stats->cpuTimerFreq
     );
     stats_manager.push_value(
-        "bgfx.wait_render:time",
+        wait_render_stat,
         float(bgfx_stats->waitRender) / bgfx_stats->cpuTimerFreq
     );
 }
@@ -582,6 +596,7 @@ Renderer::render_batch(
     const ViewportIndexSet target_viewports
 )
 {
+    KAACORE_TRACE_SCOPE("renderer", "render_batch");
     batch.each_draw_call([this, target_viewports,
                           target_render_passes](const DrawCall& call) {
         target_render_passes.each_active_index([this, target_viewports,
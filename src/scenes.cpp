@@ -11,6 +11,7 @@
 #include "kaacore/exceptions.h"
 #include "kaacore/scenes.h"
 #include "kaacore/statistics.h"
+#include "kaacore/tracing.h"
 
 namespace kaacore {
 
@@ -67,7 +68,12 @@ Scene::process_update(const Duration dt)
 void
 Scene::process_physics(const HighPrecisionDuration dt)
 {
-    StopwatchStatAutoPusher stopwatch{"scene.process_physics:time"};
+    static const auto process_physics_stat =
+        get_global_statistics_manager().register_stat(
+            "scene.process_physics:time"
+        );
+    KAACORE_TRACE_SCOPE("scene", "process_physics");
+    StopwatchStatAutoPusher stopwatch{process_physics_stat};
     for (Node* space_node : this->simulations_registry) {
         space_node->space.simulate(dt);
     }
@@ -78,10 +84,19 @@ Scene::process_nodes(
     const HighPrecisionDuration dt, const Scene::NodesQueue& processing_queue
 )
 {
-    StopwatchStatAutoPusher stopwatch{"scene.process_nodes:time"};
-    CounterStatAutoPusher transitions_counter{
-        "scene.transitions_processed:count"
-    };
+    static const auto process_nodes_stat =
+        get_global_statistics_manager().register_stat(
+            "scene.process_nodes:time"
+        );
+    static const auto transitions_stat =
+        get_global_statistics_manager().register_stat(
+            "scene.transitions_processed:count"
+        );
+    KAACORE_TRACE_SCOPE_ARG(
+        "scene", "process_nodes", "nodes", processing_queue.size()
+    );
+    StopwatchStatAutoPusher stopwatch{process_nodes_stat};
+    CounterStatAutoPusher transitions_counter{transitions_stat};
     for (Node* node : processing_queue) {
         if (node->_marked_to_delete) {
             continue;
@@ -100,20 +115,30 @@ Scene::process_nodes(
             node->body.sync_simulation_rotation();
         }
 
-        if (node->_transitions_manager) {
+        if (node->_transitions_manager._requires_stepping()) {
             node->_transitions_manager.step(node, dt);
             transitions_counter += 1;
         }
     }
+
+    transitions_counter += this->batched_transitions.size();
+    this->batched_transitions.process(dt);
 }
 
 void
 Scene::resolve_spatial_index_changes(const Scene::NodesQueue& processing_queue)
 {
-    StopwatchStatAutoPusher stopwatch{"scene.resolve_nodes:time"};
-    CounterStatAutoPusher spatial_updates_counter{
-        "scene.spatial_index_updates:count"
-    };
+    static const auto resolve_nodes_stat =
+        get_global_statistics_manager().register_stat(
+            "scene.resolve_nodes:time"
+        );
+    static const auto spatial_updates_stat =
+        get_global_statistics_manager().register_stat(
+            "scene.spatial_index_updates:count"
+        );
+    KAACORE_TRACE_SCOPE("scene", "resolve_spatial_index_changes");
+    StopwatchStatAutoPusher stopwatch{resolve_nodes_stat};
+    CounterStatAutoPusher spatial_updates_counter{spatial_updates_stat};
     for (Node* node : processing_queue) {
         if (node->_marked_to_delete) {
             continue;
@@ -130,7 +155,12 @@ void
 Scene::update_nodes_drawing_queue(const NodesQueue& processing_queue)
 {
     KAACORE_LOG_TRACE("Starting process_nodes_drawing()");
-    StopwatchStatAutoPusher stopwatch{"scene.nodes_drawing:time"};
+    static const auto nodes_drawing_stat =
+        get_global_statistics_manager().register_stat(
+            "scene.nodes_drawing:time"
+        );
+    KAACORE_TRACE_SCOPE("scene", "update_nodes_drawing_queue");
+    StopwatchStatAutoPusher stopwatch{nodes_drawing_stat};
 
     for (Node* node : processing_queue) {
         if (not node->_marked_to_delete) {
@@ -216,6 +246,7 @@ Scene::attach_frame_context(const std::unique_ptr<Renderer>& renderer)
 void
 Scene::render(const std::unique_ptr<Renderer>& renderer)
 {
+    KAACORE_TRACE_SCOPE("scene", "render");
     this->draw_queue.process_modifications();
 
     // render nodes tree
@@ -328,6 +359,30 @@ Scene::get_events() const
     return get_engine()->input_manager->events_queue;
 }
 
+std::optional<HighPrecisionDuration>
+Scene::fixed_time_step() const
+{
+    return this->_fixed_time_step;
+}
+
+void
+Scene::fixed_time_step(const std::optional<HighPrecisionDuration> step)
+{
+    KAACORE_CHECK(
+        not step or step.value() > 0us, "Time step must be greater than zero."
+    );
+    this->_fixed_time_step = step;
+}
+
+void
+Scene::step_simulation(const HighPrecisionDuration dt)
+{
+    const auto& processing_queue = this->build_processing_queue();
+    this->process_physics(dt);
+    this->process_nodes(dt, processing_queue);
+    this->remove_marked_nodes();
+}
+
 void
 Scene::_reset()
 {
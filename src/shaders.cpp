@@ -43,10 +43,7 @@ _release_used_memory(void* memory, void* _user_data)
 Memory
 _load_shader(const std::string& path)
 {
-    File file(path);
-    return Memory::copy(
-        reinterpret_cast<std::byte*>(file.content.data()), file.content.size()
-    );
+    return map_file(path);
 }
 
 Memory
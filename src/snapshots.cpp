@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+#include <chipmunk/chipmunk.h>
+
+#include "kaacore/exceptions.h"
+#include "kaacore/log.h"
+#include "kaacore/nodes.h"
+#include "kaacore/physics.h"
+#include "kaacore/scenes.h"
+
+#include "kaacore/snapshots.h"
+
+namespace kaacore {
+
+constexpr uint32_t simulation_snapshot_magic = 0x504E534B; // "KSNP"
+constexpr uint16_t simulation_snapshot_version = 3;
+
+enum struct _SnapshotRunnerState : uint8_t {
+    unprepared = 0,
+    prepared,
+    batched,
+};
+
+class _SnapshotWriter {
+  public:
+    _SnapshotWriter(std::vector<std::byte>& buffer) : _buffer(buffer) {}
+
+    template<typename T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto offset = this->_buffer.size();
+        this->_buffer.resize(offset + sizeof(T));
+        std::memcpy(this->_buffer.data() + offset, &value, sizeof(T));
+    }
+
+  private:
+    std::vector<std::byte>& _buffer;
+};
+
+class _SnapshotReader {
+  public:
+    _SnapshotReader(const std::vector<std::byte>& buffer) : _buffer(buffer) {}
+
+    template<typename T>
+    T read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        this->_check_available(sizeof(T));
+        T value;
+        std::memcpy(&value, this->_buffer.data() + this->_offset, sizeof(T));
+        this->_offset += sizeof(T);
+        return value;
+    }
+
+    bool exhausted() const { return this->_offset == this->_buffer.size(); }
+
+  private:
+    const std::vector<std::byte>& _buffer;
+    size_t _offset = 0;
+
+    void _check_available(const size_t size) const
+    {
+        KAACORE_CHECK(
+            this->_offset + size <= this->_buffer.size(),
+            "Simulation snapshot data is truncated."
+        );
+    }
+};
+
+const std::vector<Node*>&
+SimulationSnapshot::_collect_nodes(Node* space_node)
+{
+    // depth-first, pre-order traversal gives us stable nodes indexing
+    thread_local std::vector<Node*> nodes;
+    thread_local std::vector<Node*> nodes_stack;
+    nodes.clear();
+    nodes_stack.clear();
+
+    nodes_stack.push_back(space_node);
+    while (not nodes_stack.empty()) {
+        Node* node = nodes_stack.back();
+        nodes_stack.pop_back();
+        if (node->_marked_to_delete) {
+            continue;
+        }
+        nodes.push_back(node);
+        nodes_stack.insert(
+            nodes_stack.end(), node->_children.rbegin(), node->_children.rend()
+        );
+    }
+    return nodes;
+}
+
+SimulationSnapshot
+SimulationSnapshot::capture(NodePtr space_node)
+{
+    KAACORE_CHECK(space_node, "Invalid node.");
+    KAACORE_CHECK(
+        space_node->_type == NodeType::space,
+        "Invalid type - space node type expected."
+    );
+
+    SimulationSnapshot snapshot;
+    _SnapshotWriter writer{snapshot._data};
+    std::unordered_map<const NodeTransitionBase*, uint32_t> handles_indices;
+
+    const auto& nodes = _collect_nodes(space_node.get());
+    writer.write(simulation_snapshot_magic);
+    writer.write(simulation_snapshot_version);
+    writer.write(static_cast<uint32_t>(nodes.size()));
+    writer.write(space_node->space._time_acc.count());
+
+    for (Node* node : nodes) {
+        writer.write(static_cast<uint8_t>(node->_type));
+        // position and rotation of bodies are stored with simulation state
+        if (node->_type != NodeType::body) {
+            writer.write(node->_position);
+            writer.write(node->_rotation);
+        }
+        writer.write(node->_scale);
+        writer.write(node->_color);
+        if (node->_type == NodeType::body) {
+            cpBody* cp_body = node->body._cp_body;
+            writer.write(cpBodyGetPosition(cp_body));
+            writer.write(cpBodyGetAngle(cp_body));
+            writer.write(cpBodyGetVelocity(cp_body));
+            writer.write(cpBodyGetAngularVelocity(cp_body));
+            writer.write(cpBodyGetForce(cp_body));
+            writer.write(cpBodyGetTorque(cp_body));
+        } else if (node->_type == NodeType::hitbox) {
+            cpShape* cp_shape = node->hitbox._cp_shape;
+            writer.write(cpShapeGetCollisionType(cp_shape));
+            writer.write(cpShapeGetFilter(cp_shape));
+            writer.write(cpShapeGetSensor(cp_shape));
+            writer.write(cpShapeGetElasticity(cp_shape));
+            writer.write(cpShapeGetFriction(cp_shape));
+            writer.write(cpShapeGetSurfaceVelocity(cp_shape));
+        }
+
+        const auto& runners = node->_transitions_manager._runners;
+        writer.write(static_cast<uint16_t>(runners.size()));
+        for (const auto& [slot, runner] : runners) {
+            auto [it, inserted] = handles_indices.try_emplace(
+                runner->transition_handle.get(),
+                snapshot._transition_handles.size()
+            );
+            if (inserted) {
+                snapshot._transition_handles.push_back(
+                    runner->transition_handle
+                );
+            }
+            writer.write(slot);
+            writer.write(it->second);
+            writer.write(runner->elapsed_time().count());
+            if (runner->is_batched()) {
+                // origin of transition is taken when it's prepared,
+                // so it can't be prepared again on restore
+                writer.write(_SnapshotRunnerState::batched);
+                const auto [origin_value, destination_value] =
+                    runner->_batch_manager->transition_values(runner.get());
+                writer.write(origin_value);
+                writer.write(destination_value);
+            } else if (runner->transition_state_prepared) {
+                writer.write(_SnapshotRunnerState::prepared);
+            } else {
+                writer.write(_SnapshotRunnerState::unprepared);
+            }
+        }
+    }
+
+    KAACORE_LOG_DEBUG(
+        "Captured simulation snapshot of space node {} - nodes: {}, size: {}",
+        fmt::ptr(space_node.get()), nodes.size(), snapshot._data.size()
+    );
+    return snapshot;
+}
+
+void
+SimulationSnapshot::restore(NodePtr space_node) const
+{
+    KAACORE_CHECK(*this, "Simulation snapshot is empty.");
+    KAACORE_CHECK(space_node, "Invalid node.");
+    KAACORE_CHECK(
+        space_node->_type == NodeType::space,
+        "Invalid type - space node type expected."
+    );
+    KAACORE_CHECK(
+        not space_node->space.locked(),
+        "Cannot restore simulation snapshot while space is locked."
+    );
+
+    _SnapshotReader reader{this->_data};
+    KAACORE_CHECK(
+        reader.read<uint32_t>() == simulation_snapshot_magic and
+            reader.read<uint16_t>() == simulation_snapshot_version,
+        "Invalid simulation snapshot data."
+    );
+
+    const auto& nodes = _collect_nodes(space_node.get());
+    KAACORE_CHECK(
+        reader.read<uint32_t>() == nodes.size(),
+        "Simulation snapshot does not match nodes tree."
+    );
+    cpSpace* cp_space = space_node->space._cp_space;
+    space_node->space._time_acc =
+        HighPrecisionDuration(reader.read<HighPrecisionDuration::rep>());
+
+    thread_local std::vector<NodeTransitionSlot> restored_slots;
+    for (Node* node : nodes) {
+        KAACORE_CHECK(
+            static_cast<NodeType>(reader.read<uint8_t>()) == node->_type,
+            "Simulation snapshot does not match nodes tree."
+        );
+        if (node->_type != NodeType::body) {
+            // setters are skipped for unchanged values, since they
+            // update hitboxes regardless
+            const auto position = reader.read<glm::dvec2>();
+            if (position != node->_position) {
+                node->position(position);
+            }
+            const auto rotation = reader.read<double>();
+            if (rotation != node->_rotation) {
+                node->rotation(rotation);
+            }
+        }
+        node->scale(reader.read<glm::dvec2>());
+        node->color(reader.read<glm::dvec4>());
+        if (node->_type == NodeType::body) {
+            cpBody* cp_body = node->body._cp_body;
+            cpBodySetPosition(cp_body, reader.read<cpVect>());
+            cpBodySetAngle(cp_body, reader.read<cpFloat>());
+            cpBodySetVelocity(cp_body, reader.read<cpVect>());
+            cpBodySetAngularVelocity(cp_body, reader.read<cpFloat>());
+            cpBodySetForce(cp_body, reader.read<cpVect>());
+            cpBodySetTorque(cp_body, reader.read<cpFloat>());
+            if (cpBodyGetType(cp_body) == CP_BODY_TYPE_STATIC and
+                cpBodyGetSpace(cp_body) == cp_space) {
+                cpSpaceReindexShapesForBody(cp_space, cp_body);
+            }
+            node->body.sync_simulation_position();
+            node->body.sync_simulation_rotation();
+        } else if (node->_type == NodeType::hitbox) {
+            cpShape* cp_shape = node->hitbox._cp_shape;
+            cpShapeSetCollisionType(
+                cp_shape, reader.read<cpCollisionType>()
+            );
+            cpShapeSetFilter(cp_shape, reader.read<cpShapeFilter>());
+            cpShapeSetSensor(cp_shape, reader.read<cpBool>());
+            cpShapeSetElasticity(cp_shape, reader.read<cpFloat>());
+            cpShapeSetFriction(cp_shape, reader.read<cpFloat>());
+            cpShapeSetSurfaceVelocity(cp_shape, reader.read<cpVect>());
+        }
+
+        auto& manager = node->_transitions_manager;
+        KAACORE_CHECK(
+            not manager._is_processing,
+            "Cannot restore simulation snapshot while processing transitions."
+        );
+        restored_slots.clear();
+        const auto runners_count = reader.read<uint16_t>();
+        for (uint16_t i = 0; i < runners_count; i++) {
+            const auto slot = reader.read<NodeTransitionSlot>();
+            const auto handle_index = reader.read<uint32_t>();
+            const auto current_time =
+                HighPrecisionDuration(reader.read<HighPrecisionDuration::rep>()
+                );
+            KAACORE_CHECK(
+                handle_index < this->_transition_handles.size(),
+                "Invalid simulation snapshot data."
+            );
+            const auto& handle = this->_transition_handles[handle_index];
+            const auto runner_state = reader.read<_SnapshotRunnerState>();
+
+            auto it = manager._find_runner(slot);
+            if (it == manager._runners.end()) {
+                // transition finished after snapshot was taken
+                manager._apply_update(slot, handle);
+                it = manager._find_runner(slot);
+            }
+            auto& runner = *it->second;
+            if (runner_state == _SnapshotRunnerState::batched) {
+                const auto origin_value = reader.read<glm::dvec4>();
+                const auto destination_value = reader.read<glm::dvec4>();
+                auto params = handle->batched_params(node);
+                if (node->_scene and params) {
+                    // re-applied with its original origin, even if
+                    // it was restarted after snapshot was taken
+                    params->origin_value = origin_value;
+                    params->destination_value = destination_value;
+                    runner.setup(handle);
+                    node->_scene->batched_transitions.add(
+                        node, &runner, *params, current_time
+                    );
+                    runner.transition_state_prepared = true;
+                    restored_slots.push_back(slot);
+                    continue;
+                }
+            }
+            if (runner.transition_handle != handle or
+                (runner_state == _SnapshotRunnerState::unprepared and
+                 runner.transition_state_prepared)) {
+                // state will be prepared again on next step,
+                // from restored node attributes
+                runner.setup(handle);
+            }
+            runner.elapsed_time(current_time);
+            restored_slots.push_back(slot);
+        }
+
+        // drop transitions started after snapshot was taken
+        manager._runners.erase(
+            std::remove_if(
+                manager._runners.begin(), manager._runners.end(),
+                [](const auto& entry) {
+                    return std::find(
+                               restored_slots.begin(), restored_slots.end(),
+                               entry.first
+                           ) == restored_slots.end();
+                }
+            ),
+            manager._runners.end()
+        );
+    }
+
+    KAACORE_CHECK(reader.exhausted(), "Invalid simulation snapshot data.");
+}
+
+const std::vector<std::byte>&
+SimulationSnapshot::data() const
+{
+    return this->_data;
+}
+
+size_t
+SimulationSnapshot::size() const
+{
+    return this->_data.size();
+}
+
+SimulationSnapshot::operator bool() const
+{
+    return not this->_data.empty();
+}
+
+} // namespace kaacore
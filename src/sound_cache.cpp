@@ -0,0 +1,142 @@
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "kaacore/sound_cache.h"
+
+namespace kaacore {
+
+struct _SoundCacheEntry {
+    // owns decoded sound while it's cached
+    std::shared_ptr<Mix_Chunk> chunk;
+    // chunk given to users, released back to the cache with the last copy
+    std::weak_ptr<Mix_Chunk> used_chunk;
+    bool unused = false;
+    std::list<std::string>::iterator unused_position;
+};
+
+struct _SoundCacheState : std::enable_shared_from_this<_SoundCacheState> {
+    mutable std::mutex lock;
+    size_t budget;
+    size_t usage = 0;
+    std::unordered_map<std::string, _SoundCacheEntry> entries;
+    // most recently used first
+    std::list<std::string> unused_paths;
+
+    std::shared_ptr<Mix_Chunk>
+    use(const std::string& path, _SoundCacheEntry& entry)
+    {
+        if (auto used_chunk = entry.used_chunk.lock()) {
+            return used_chunk;
+        }
+        if (entry.unused) {
+            this->usage -= entry.chunk->alen;
+            this->unused_paths.erase(entry.unused_position);
+            entry.unused = false;
+        }
+        // owning chunk is kept by the deleter, so users are not
+        // affected by eviction or cache destruction
+        std::weak_ptr<_SoundCacheState> weak_state = this->shared_from_this();
+        std::shared_ptr<Mix_Chunk> used_chunk{
+            entry.chunk.get(),
+            [weak_state, path, chunk = entry.chunk](Mix_Chunk*) {
+                if (auto state = weak_state.lock()) {
+                    state->release(path, chunk.get());
+                }
+            }
+        };
+        entry.used_chunk = used_chunk;
+        return used_chunk;
+    }
+
+    void release(const std::string& path, const Mix_Chunk* chunk)
+    {
+        std::lock_guard lock{this->lock};
+        auto it = this->entries.find(path);
+        // sound could be used again before it was released
+        if (it == this->entries.end() or it->second.chunk.get() != chunk or
+            it->second.unused or not it->second.used_chunk.expired()) {
+            return;
+        }
+        auto& entry = it->second;
+        entry.unused = true;
+        entry.unused_position =
+            this->unused_paths.insert(this->unused_paths.begin(), path);
+        this->usage += entry.chunk->alen;
+        this->trim();
+    }
+
+    void trim()
+    {
+        while (this->usage > this->budget and not this->unused_paths.empty()) {
+            auto it = this->entries.find(this->unused_paths.back());
+            this->usage -= it->second.chunk->alen;
+            this->unused_paths.pop_back();
+            this->entries.erase(it);
+        }
+    }
+};
+
+SoundCache::SoundCache(const size_t budget)
+    : _state(std::make_shared<_SoundCacheState>())
+{
+    this->_state->budget = budget;
+}
+
+SoundCache::~SoundCache() = default;
+
+std::shared_ptr<Mix_Chunk>
+SoundCache::get(const std::string& path)
+{
+    auto& state = *this->_state;
+    std::lock_guard lock{state.lock};
+    auto it = state.entries.find(path);
+    if (it == state.entries.end()) {
+        return nullptr;
+    }
+    return state.use(path, it->second);
+}
+
+std::shared_ptr<Mix_Chunk>
+SoundCache::insert(const std::string& path, std::shared_ptr<Mix_Chunk> chunk)
+{
+    auto& state = *this->_state;
+    std::lock_guard lock{state.lock};
+    // same sound could be decoded twice in parallel
+    auto [it, inserted] = state.entries.try_emplace(path);
+    if (inserted) {
+        it->second.chunk = std::move(chunk);
+    }
+    return state.use(path, it->second);
+}
+
+bool
+SoundCache::contains(const std::string& path) const
+{
+    std::lock_guard lock{this->_state->lock};
+    return this->_state->entries.count(path);
+}
+
+size_t
+SoundCache::budget() const
+{
+    std::lock_guard lock{this->_state->lock};
+    return this->_state->budget;
+}
+
+void
+SoundCache::budget(const size_t budget)
+{
+    std::lock_guard lock{this->_state->lock};
+    this->_state->budget = budget;
+    this->_state->trim();
+}
+
+size_t
+SoundCache::usage() const
+{
+    std::lock_guard lock{this->_state->lock};
+    return this->_state->usage;
+}
+
+} // namespace kaacore
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cstring>
+
+#include "kaacore/exceptions.h"
+#include "kaacore/files.h"
+#include "kaacore/log.h"
+
+#include "kaacore/sound_streams.h"
+
+namespace kaacore {
+
+constexpr size_t wav_input_chunk_frames = 4096;
+constexpr uint16_t wav_format_pcm = 1;
+constexpr uint16_t wav_format_float = 3;
+constexpr uint16_t wav_format_extensible = 0xFFFE;
+
+inline uint16_t
+_read_u16(const std::byte* data)
+{
+    return std::to_integer<uint16_t>(data[0]) |
+           std::to_integer<uint16_t>(data[1]) << 8;
+}
+
+inline uint32_t
+_read_u32(const std::byte* data)
+{
+    return uint32_t(_read_u16(data)) | uint32_t(_read_u16(data + 2)) << 16;
+}
+
+SDL_AudioFormat
+_wav_sample_format(const uint16_t format_tag, const uint16_t bits)
+{
+    if (format_tag == wav_format_pcm) {
+        switch (bits) {
+            case 8:
+                return AUDIO_U8;
+            case 16:
+                return AUDIO_S16LSB;
+            case 32:
+                return AUDIO_S32LSB;
+        }
+    } else if (format_tag == wav_format_float and bits == 32) {
+        return AUDIO_F32LSB;
+    }
+    return 0;
+}
+
+WavStreamDecoder::WavStreamDecoder(
+    const std::string& path, const SDL_AudioFormat format,
+    const uint8_t channels, const int frequency, const int loops
+)
+    : _file(map_file(path)), _loops_left(loops)
+{
+    const std::byte* data = this->_file.get();
+    const size_t size = this->_file.size();
+    if (size < 12 or std::memcmp(data, "RIFF", 4) != 0 or
+        std::memcmp(data + 8, "WAVE", 4) != 0) {
+        throw kaacore::exception("Not a WAV file: " + path);
+    }
+
+    uint16_t format_tag = 0;
+    uint16_t source_channels = 0;
+    uint32_t source_frequency = 0;
+    uint16_t block_align = 0;
+    uint16_t bits = 0;
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        const std::byte* chunk = data + offset;
+        const size_t chunk_size =
+            std::min<size_t>(_read_u32(chunk + 4), size - offset - 8);
+        if (std::memcmp(chunk, "fmt ", 4) == 0 and chunk_size >= 16) {
+            format_tag = _read_u16(chunk + 8);
+            source_channels = _read_u16(chunk + 10);
+            source_frequency = _read_u32(chunk + 12);
+            block_align = _read_u16(chunk + 20);
+            bits = _read_u16(chunk + 22);
+            if (format_tag == wav_format_extensible and chunk_size >= 26) {
+                // sub-format GUID starts with actual format tag
+                format_tag = _read_u16(chunk + 32);
+            }
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            this->_samples = chunk + 8;
+            this->_samples_size = chunk_size;
+        }
+        // chunks are padded to even size
+        offset += 8 + chunk_size + (chunk_size & 1);
+    }
+
+    const auto source_format = _wav_sample_format(format_tag, bits);
+    if (source_format == 0 or source_channels == 0 or block_align == 0) {
+        throw kaacore::exception(fmt::format(
+            "Unsupported WAV file: {} (format: {}, bits: {}).", path,
+            format_tag, bits
+        ));
+    }
+    this->_samples_size -= this->_samples_size % block_align;
+    if (this->_samples_size == 0) {
+        throw kaacore::exception("WAV file has no samples: " + path);
+    }
+    this->_input_chunk_size = wav_input_chunk_frames * block_align;
+    this->_frame_size = SDL_AUDIO_BITSIZE(format) / 8 * channels;
+
+    this->_stream = SDL_NewAudioStream(
+        source_format, source_channels, source_frequency, format, channels,
+        frequency
+    );
+    if (this->_stream == nullptr) {
+        throw kaacore::exception(
+            fmt::format("Failed to create audio stream: {}.", SDL_GetError())
+        );
+    }
+    KAACORE_LOG_DEBUG(
+        "Streaming WAV file: {} ({} channels, {} Hz, {} bits)", path,
+        source_channels, source_frequency, bits
+    );
+}
+
+WavStreamDecoder::~WavStreamDecoder()
+{
+    if (this->_stream) {
+        SDL_FreeAudioStream(this->_stream);
+    }
+}
+
+size_t
+WavStreamDecoder::frame_size() const
+{
+    return this->_frame_size;
+}
+
+size_t
+WavStreamDecoder::decode(std::byte* output, const size_t size)
+{
+    const size_t requested_size = size - size % this->_frame_size;
+    while (not this->_flushed and
+           size_t(SDL_AudioStreamAvailable(this->_stream)) < requested_size) {
+        if (this->_position == this->_samples_size) {
+            if (this->_loops_left == 1) {
+                // converter keeps some samples until flushed
+                SDL_AudioStreamFlush(this->_stream);
+                this->_flushed = true;
+                break;
+            }
+            if (this->_loops_left > 1) {
+                this->_loops_left--;
+            }
+            this->_position = 0;
+        }
+        const size_t chunk_size = std::min(
+            this->_input_chunk_size, this->_samples_size - this->_position
+        );
+        if (SDL_AudioStreamPut(
+                this->_stream, this->_samples + this->_position, chunk_size
+            ) != 0) {
+            KAACORE_LOG_ERROR("Failed to convert audio: {}", SDL_GetError());
+            SDL_AudioStreamFlush(this->_stream);
+            this->_flushed = true;
+            break;
+        }
+        this->_position += chunk_size;
+    }
+    const int decoded_size =
+        SDL_AudioStreamGet(this->_stream, output, requested_size);
+    return decoded_size > 0 ? decoded_size : 0;
+}
+
+} // namespace kaacore
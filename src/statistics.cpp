@@ -1,25 +1,225 @@
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <limits>
 #include <mutex>
 
 #include "kaacore/engine.h"
+#include "kaacore/threading.h"
 
 #include "kaacore/statistics.h"
 
 namespace kaacore {
 
-FrameStatisticTracker::FrameStatisticTracker() : _size(0u)
+// limits bucket count (and recorded values at given resolution)
+constexpr uint8_t statistic_histogram_max_shift = 48u;
+constexpr size_t statistic_sliding_window_parts = 4u;
+
+StatisticHistogram::StatisticHistogram(
+    const double resolution, const uint8_t significant_bits
+)
+    : _resolution(resolution), _significant_bits(significant_bits),
+      _min_value(std::nan("")), _max_value(std::nan(""))
+{
+    KAACORE_CHECK(resolution > 0., "Histogram resolution must be positive.");
+    KAACORE_CHECK(
+        significant_bits >= 1 and significant_bits <= 16,
+        "Histogram significant bits must be in [1, 16] range."
+    );
+}
+
+void
+StatisticHistogram::record(const double value)
+{
+    if (std::isnan(value)) {
+        return;
+    }
+    const double max_units = std::ldexp(1., statistic_histogram_max_shift);
+    const double units =
+        std::clamp(std::round(value / this->_resolution), 0., max_units);
+    const size_t index = this->_bucket_index(uint64_t(units));
+    if (index >= this->_counts.size()) {
+        this->_counts.resize(index + 1, 0u);
+    }
+    this->_counts[index]++;
+    if (this->_count == 0) {
+        this->_min_value = this->_max_value = value;
+    } else {
+        this->_min_value = std::min(this->_min_value, value);
+        this->_max_value = std::max(this->_max_value, value);
+    }
+    this->_count++;
+}
+
+void
+StatisticHistogram::merge(const StatisticHistogram& other)
+{
+    KAACORE_ASSERT(
+        this->_resolution == other._resolution and
+            this->_significant_bits == other._significant_bits,
+        "Can't merge histograms with different precision."
+    );
+    if (other._count == 0) {
+        return;
+    }
+    if (other._counts.size() > this->_counts.size()) {
+        this->_counts.resize(other._counts.size(), 0u);
+    }
+    for (size_t i = 0; i < other._counts.size(); i++) {
+        this->_counts[i] += other._counts[i];
+    }
+    if (this->_count == 0) {
+        this->_min_value = other._min_value;
+        this->_max_value = other._max_value;
+    } else {
+        this->_min_value = std::min(this->_min_value, other._min_value);
+        this->_max_value = std::max(this->_max_value, other._max_value);
+    }
+    this->_count += other._count;
+}
+
+void
+StatisticHistogram::reset()
+{
+    // keep allocated buckets, window will likely need them again
+    std::fill(this->_counts.begin(), this->_counts.end(), 0u);
+    this->_count = 0;
+    this->_min_value = this->_max_value = std::nan("");
+}
+
+uint64_t
+StatisticHistogram::count() const
+{
+    return this->_count;
+}
+
+double
+StatisticHistogram::min_value() const
+{
+    return this->_min_value;
+}
+
+double
+StatisticHistogram::max_value() const
+{
+    return this->_max_value;
+}
+
+double
+StatisticHistogram::percentile(const double percentile) const
+{
+    if (this->_count == 0) {
+        return std::nan("");
+    }
+    const uint64_t rank = std::max<uint64_t>(
+        1u, std::ceil(std::clamp(percentile, 0., 100.) / 100. * this->_count)
+    );
+    uint64_t seen_count = 0;
+    for (size_t i = 0; i < this->_counts.size(); i++) {
+        seen_count += this->_counts[i];
+        if (seen_count >= rank) {
+            return std::clamp(
+                this->_bucket_value(i), this->_min_value, this->_max_value
+            );
+        }
+    }
+    return this->_max_value;
+}
+
+size_t
+StatisticHistogram::_bucket_index(const uint64_t units) const
+{
+    // first 2^bits buckets hold exact values, then every power of two
+    // range is split into 2^(bits - 1) buckets
+    const uint64_t exact_buckets = uint64_t(1u) << this->_significant_bits;
+    const uint64_t half_buckets = exact_buckets / 2;
+    if (units < exact_buckets) {
+        return units;
+    }
+    uint8_t shift = 1;
+    while ((units >> shift) >= exact_buckets) {
+        shift++;
+    }
+    return exact_buckets + (shift - 1) * half_buckets +
+           ((units >> shift) - half_buckets);
+}
+
+double
+StatisticHistogram::_bucket_value(const size_t index) const
+{
+    const uint64_t exact_buckets = uint64_t(1u) << this->_significant_bits;
+    const uint64_t half_buckets = exact_buckets / 2;
+    if (index < exact_buckets) {
+        return index * this->_resolution;
+    }
+    const uint8_t shift = (index - exact_buckets) / half_buckets + 1;
+    const uint64_t lowest_units =
+        (half_buckets + (index - exact_buckets) % half_buckets) << shift;
+    // middle of the bucket
+    const double units = lowest_units + ((uint64_t(1u) << shift) - 1) / 2.;
+    return units * this->_resolution;
+}
+
+FrameStatisticTracker::FrameStatisticTracker(
+    const StatisticWindowOptions& window_options
+)
+    : _size(0u), _window_options(window_options)
 {
     this->_buffer_end_position = this->_values_ring_buffer.begin();
     this->_next_value_position = this->_values_ring_buffer.begin();
     this->_last_value_position = this->_values_ring_buffer.begin();
     *this->_last_value_position = std::nan("");
+
+    KAACORE_CHECK(
+        window_options.length > 0, "Statistic window can't be empty."
+    );
+    size_t histograms_count;
+    switch (window_options.reset) {
+        case StatisticWindowReset::cumulative:
+            histograms_count = 1;
+            this->_histogram_capacity = std::numeric_limits<uint32_t>::max();
+            break;
+        case StatisticWindowReset::tumbling:
+            // current one and last full one
+            histograms_count = 2;
+            this->_histogram_capacity = window_options.length;
+            break;
+        case StatisticWindowReset::sliding:
+            histograms_count = statistic_sliding_window_parts;
+            this->_histogram_capacity = std::max<uint32_t>(
+                1u, window_options.length / statistic_sliding_window_parts
+            );
+            break;
+    }
+    this->_histograms.resize(
+        histograms_count,
+        StatisticHistogram{
+            window_options.resolution, window_options.significant_bits
+        }
+    );
+}
+
+void
+FrameStatisticTracker::reset_window()
+{
+    for (auto& histogram : this->_histograms) {
+        histogram.reset();
+    }
+    this->_current_histogram = 0;
 }
 
 void
 FrameStatisticTracker::push_value(const double value)
 {
+    if (this->_histograms[this->_current_histogram].count() >=
+        this->_histogram_capacity) {
+        this->_current_histogram =
+            (this->_current_histogram + 1) % this->_histograms.size();
+        this->_histograms[this->_current_histogram].reset();
+    }
+    this->_histograms[this->_current_histogram].record(value);
+
     *this->_next_value_position = value;
     this->_last_value_position = this->_next_value_position;
     this->_next_value_position++;
@@ -80,20 +280,157 @@ FrameStatisticTracker::analyse() const
         stats.standard_deviation = std::nan("");
     }
 
+    const StatisticHistogram* window_histogram;
+    StatisticHistogram merged_histogram{
+        this->_window_options.resolution,
+        this->_window_options.significant_bits
+    };
+    if (this->_window_options.reset == StatisticWindowReset::tumbling) {
+        // current window is used only until first one fills
+        const auto& full_histogram =
+            this->_histograms[(this->_current_histogram + 1) % 2];
+        window_histogram = full_histogram.count() > 0
+                               ? &full_histogram
+                               : &this->_histograms[this->_current_histogram];
+    } else {
+        for (const auto& histogram : this->_histograms) {
+            merged_histogram.merge(histogram);
+        }
+        window_histogram = &merged_histogram;
+    }
+    stats.window_samples_count = window_histogram->count();
+    stats.percentile_50 = window_histogram->percentile(50.);
+    stats.percentile_95 = window_histogram->percentile(95.);
+    stats.percentile_99 = window_histogram->percentile(99.);
+    stats.percentile_99_9 = window_histogram->percentile(99.9);
+
     return stats;
 }
 
+struct _StatSample {
+    StatHandle stat;
+    double value;
+};
+
+std::atomic<uint64_t> _next_statistics_manager_id = 1;
+
+StatisticsManager::StatisticsManager() : _id(_next_statistics_manager_id++)
+{}
+
+StatisticsManager::~StatisticsManager() = default;
+
+StatHandle
+StatisticsManager::register_stat(
+    const std::string& stat_name, const StatisticWindowOptions& window_options
+)
+{
+    std::lock_guard lock{this->_mutex};
+    auto [iter, inserted] =
+        this->_handles.try_emplace(stat_name, this->_trackers.size());
+    if (inserted) {
+        this->_trackers.emplace_back(
+            std::piecewise_construct, std::forward_as_tuple(stat_name),
+            std::forward_as_tuple(window_options)
+        );
+    }
+    return iter->second;
+}
+
+void
+StatisticsManager::push_value(const StatHandle stat, const double value)
+{
+    const _StatSample sample{stat, value};
+    auto& buffer = this->_get_thread_buffer();
+    if (buffer.free_space() < sizeof(sample)) {
+        std::lock_guard lock{this->_mutex};
+        this->_merge_buffer(buffer);
+    }
+    buffer.write(reinterpret_cast<const std::byte*>(&sample), sizeof(sample));
+}
+
 void
 StatisticsManager::push_value(const std::string& stat_name, const double value)
 {
+    this->push_value(this->register_stat(stat_name), value);
+}
+
+void
+StatisticsManager::flush()
+{
+    std::lock_guard lock{this->_mutex};
+    for (auto& thread_buffer : this->_thread_buffers) {
+        this->_merge_buffer(*thread_buffer.samples);
+    }
+}
+
+void
+StatisticsManager::reset_window(const StatHandle stat)
+{
+    // samples pushed before reset shouldn't land in the new window
+    this->flush();
     std::lock_guard lock{this->_mutex};
-    auto [iter, inserted] = this->_trackers.try_emplace(stat_name);
-    iter->second.push_value(value);
+    KAACORE_CHECK(
+        stat < this->_trackers.size(), "Invalid stat handle: {}.", stat
+    );
+    this->_trackers[stat].second.reset_window();
+}
+
+SpscRingBuffer&
+StatisticsManager::_get_thread_buffer()
+{
+    thread_local uint64_t cached_manager_id = 0;
+    thread_local SpscRingBuffer* cached_buffer = nullptr;
+    if (cached_manager_id == this->_id) {
+        return *cached_buffer;
+    }
+
+    const auto thread_id = std::this_thread::get_id();
+    std::lock_guard lock{this->_mutex};
+    auto it = std::find_if(
+        this->_thread_buffers.begin(), this->_thread_buffers.end(),
+        [thread_id](const auto& thread_buffer) {
+            return thread_buffer.thread_id == thread_id;
+        }
+    );
+    if (it == this->_thread_buffers.end()) {
+        this->_thread_buffers.push_back(
+            {thread_id,
+             std::make_unique<SpscRingBuffer>(
+                 statistics_thread_buffer_size * sizeof(_StatSample)
+             )}
+        );
+        it = std::prev(this->_thread_buffers.end());
+    }
+    cached_manager_id = this->_id;
+    cached_buffer = it->samples.get();
+    return *cached_buffer;
+}
+
+void
+StatisticsManager::_merge_buffer(SpscRingBuffer& buffer)
+{
+    // called with lock held, so buffer has single consumer
+    std::array<_StatSample, 256> samples;
+    while (size_t read_size = buffer.read(
+               reinterpret_cast<std::byte*>(samples.data()),
+               sizeof(samples)
+           )) {
+        for (size_t i = 0; i < read_size / sizeof(_StatSample); i++) {
+            KAACORE_ASSERT(
+                samples[i].stat < this->_trackers.size(),
+                "Invalid stat handle: {}.", samples[i].stat
+            );
+            this->_trackers[samples[i].stat].second.push_value(
+                samples[i].value
+            );
+        }
+    }
 }
 
 std::vector<std::pair<std::string, StatisticAnalysis>>
 StatisticsManager::get_analysis_all()
 {
+    this->flush();
     std::vector<std::pair<std::string, StatisticAnalysis>> report;
     std::lock_guard lock{this->_mutex};
 
@@ -107,6 +444,7 @@ StatisticsManager::get_analysis_all()
 std::vector<std::pair<std::string, double>>
 StatisticsManager::get_last_all()
 {
+    this->flush();
     std::vector<std::pair<std::string, double>> last_values;
     std::lock_guard lock{this->_mutex};
 
@@ -118,13 +456,19 @@ StatisticsManager::get_last_all()
 }
 
 inline void
-_push_stat_to_manager(const std::string& stat_name, const double value)
+_push_stat_to_manager(const StatHandle stat, const double value)
 {
-    get_global_statistics_manager().push_value(stat_name, value);
+    get_global_statistics_manager().push_value(stat, value);
 }
 
+StatAutoPusher::StatAutoPusher(const StatHandle stat) : _stat(stat) {}
+
 StatAutoPusher::StatAutoPusher(const std::string& stat_name)
-    : _stat_name(stat_name)
+    : _stat(get_global_statistics_manager().register_stat(stat_name))
+{}
+
+CounterStatAutoPusher::CounterStatAutoPusher(const StatHandle stat)
+    : StatAutoPusher(stat), _counter_value(0)
 {}
 
 CounterStatAutoPusher::CounterStatAutoPusher(const std::string& stat_name)
@@ -133,7 +477,7 @@ CounterStatAutoPusher::CounterStatAutoPusher(const std::string& stat_name)
 
 CounterStatAutoPusher::~CounterStatAutoPusher()
 {
-    _push_stat_to_manager(this->_stat_name, this->_counter_value);
+    _push_stat_to_manager(this->_stat, this->_counter_value);
 }
 
 CounterStatAutoPusher&
@@ -143,6 +487,10 @@ CounterStatAutoPusher::operator+=(int32_t value)
     return *this;
 }
 
+StopwatchStatAutoPusher::StopwatchStatAutoPusher(const StatHandle stat)
+    : StatAutoPusher(stat), _start_time(StopwatchClock::now())
+{}
+
 StopwatchStatAutoPusher::StopwatchStatAutoPusher(const std::string& stat_name)
     : StatAutoPusher(stat_name), _start_time(StopwatchClock::now())
 {}
@@ -150,7 +498,7 @@ StopwatchStatAutoPusher::StopwatchStatAutoPusher(const std::string& stat_name)
 StopwatchStatAutoPusher::~StopwatchStatAutoPusher()
 {
     StopwatchUnit time_delta = StopwatchClock::now() - this->_start_time;
-    _push_stat_to_manager(this->_stat_name, time_delta.count());
+    _push_stat_to_manager(this->_stat, time_delta.count());
 }
 
 StatisticsManager&
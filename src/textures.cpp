@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include <bx/file.h>
 
@@ -6,12 +11,32 @@
 #include "kaacore/exceptions.h"
 #include "kaacore/files.h"
 #include "kaacore/log.h"
+#include "kaacore/statistics.h"
 #include "kaacore/textures.h"
+#include "kaacore/threading.h"
 
 namespace kaacore {
 
 static bx::DefaultAllocator texture_image_allocator;
 ResourcesRegistry<std::string, ImageTexture> _image_textures_registry;
+// textures remove themselves from these on destruction
+std::vector<ImageTexture*> _pending_image_textures;
+
+struct _TexturesResidency {
+    size_t memory_budget = 0;
+    size_t resident_bytes = 0;
+    uint64_t frame = 0;
+    uint64_t evictions = 0;
+    uint64_t reloads = 0;
+    uint64_t pushed_evictions = 0;
+    uint64_t pushed_reloads = 0;
+    // most recently drawn first
+    std::list<ImageTexture*> resident_textures;
+};
+
+_TexturesResidency _textures_residency;
+// images may be released by renderer thread once uploaded
+std::atomic<size_t> _cpu_image_bytes = 0;
 
 void
 initialize_textures()
@@ -25,18 +50,126 @@ uninitialize_textures()
     _image_textures_registry.uninitialze();
 }
 
+void
+process_pending_textures()
+{
+    auto is_finished = [](ImageTexture* texture) {
+        if (not texture->_pending_image.valid()) {
+            return true;
+        }
+        if (texture->_pending_image.wait_for(std::chrono::seconds::zero()) !=
+            std::future_status::ready) {
+            return false;
+        }
+        try {
+            texture->_finish_loading();
+        } catch (const std::exception& exc) {
+            KAACORE_LOG_ERROR(
+                "Failed to load image {}: {}", texture->path, exc.what()
+            );
+        }
+        return true;
+    };
+    _pending_image_textures.erase(
+        std::remove_if(
+            _pending_image_textures.begin(), _pending_image_textures.end(),
+            is_finished
+        ),
+        _pending_image_textures.end()
+    );
+}
+
+void
+set_textures_memory_budget(const size_t budget)
+{
+    _textures_residency.memory_budget = budget;
+}
+
+size_t
+get_textures_memory_budget()
+{
+    return _textures_residency.memory_budget;
+}
+
+TexturesResidencyStats
+get_textures_residency_stats()
+{
+    return {
+        _textures_residency.memory_budget, _textures_residency.resident_bytes,
+        _textures_residency.resident_textures.size(),
+        _textures_residency.evictions, _textures_residency.reloads,
+        _cpu_image_bytes
+    };
+}
+
+void
+update_textures_residency()
+{
+    auto& residency = _textures_residency;
+    auto& resident_textures = residency.resident_textures;
+    while (residency.memory_budget > 0 and
+           residency.resident_bytes > residency.memory_budget and
+           not resident_textures.empty()) {
+        auto texture = resident_textures.back();
+        // remaining textures are used by current frame
+        if (texture->_last_bind_frame == residency.frame) {
+            break;
+        }
+        texture->_evict();
+    }
+    residency.frame++;
+
+    auto& stats_manager = get_global_statistics_manager();
+    static const auto resident_stat =
+        stats_manager.register_stat("textures.resident:memory");
+    static const auto cpu_images_stat =
+        stats_manager.register_stat("textures.cpu_images:memory");
+    static const auto evictions_stat =
+        stats_manager.register_stat("textures.evictions:count");
+    static const auto reloads_stat =
+        stats_manager.register_stat("textures.reloads:count");
+    stats_manager.push_value(
+        resident_stat, double(residency.resident_bytes) / (1024. * 1024.)
+    );
+    stats_manager.push_value(
+        cpu_images_stat, double(_cpu_image_bytes) / (1024. * 1024.)
+    );
+    stats_manager.push_value(
+        evictions_stat, residency.evictions - residency.pushed_evictions
+    );
+    stats_manager.push_value(
+        reloads_stat, residency.reloads - residency.pushed_reloads
+    );
+    residency.pushed_evictions = residency.evictions;
+    residency.pushed_reloads = residency.reloads;
+}
+
 void
 _destroy_image_container(bimg::ImageContainer* image_container)
 {
     bimg::imageFree(image_container);
 }
 
+// Shared images are counted in CPU image memory statistic
+std::shared_ptr<bimg::ImageContainer>
+_share_image_container(bimg::ImageContainer* image_container)
+{
+    _cpu_image_bytes += image_container->m_size;
+    return std::shared_ptr<bimg::ImageContainer>(
+        image_container,
+        [](bimg::ImageContainer* image_container) {
+            _cpu_image_bytes -= image_container->m_size;
+            _destroy_image_container(image_container);
+        }
+    );
+}
+
 bimg::ImageContainer*
 load_image(const uint8_t* data, size_t size)
 {
     bimg::ImageContainer* image_container =
         bimg::imageParse(&texture_image_allocator, data, size);
-    assert(image_container != NULL);
+    KAACORE_CHECK(image_container != nullptr, "Failed to decode image.");
 
     KAACORE_LOG_INFO(
         "Image details - width: {}, height: {}, depth: {}, layers: {}, alpha: "
@@ -53,9 +186,11 @@ bimg::ImageContainer*
 load_image(const std::string& path)
 {
     KAACORE_LOG_INFO("Loading image from file: {}", path);
-    File file(path);
-    KAACORE_LOG_INFO("Loaded file size: {}", file.content.size());
-    return load_image(file.content.data(), file.content.size());
+    Memory memory = map_file(path);
+    KAACORE_LOG_INFO("Loaded file size: {}", memory.size());
+    return load_image(
+        reinterpret_cast<const uint8_t*>(memory.get()), memory.size()
+    );
 }
 
 bimg::ImageContainer*
@@ -63,19 +198,220 @@ load_raw_image(
     bimg::TextureFormat::Enum format, uint16_t width, uint16_t height,
     const std::vector<uint8_t>& data
 )
+{
+    return load_raw_image(format, width, height, data.data());
+}
+
+bimg::ImageContainer*
+load_raw_image(
+    bimg::TextureFormat::Enum format, uint16_t width, uint16_t height,
+    const uint8_t* data
+)
 {
     bimg::ImageContainer* image_container = bimg::imageAlloc(
         &texture_image_allocator, format, width, height, 1, 1, false, false,
-        data.data()
+        data
     );
 
     assert(image_container != NULL);
     return image_container;
 }
 
+void
+_downsample_rgba8(const bimg::ImageMip& source, const bimg::ImageMip& target)
+{
+    const auto source_data = source.m_data;
+    auto target_data = const_cast<uint8_t*>(target.m_data);
+    get_worker_pool().parallel_for(target.m_height, [&](const size_t y) {
+        const size_t rows[2] = {
+            std::min<size_t>(2 * y, source.m_height - 1),
+            std::min<size_t>(2 * y + 1, source.m_height - 1)
+        };
+        for (size_t x = 0; x < target.m_width; x++) {
+            const size_t columns[2] = {
+                std::min<size_t>(2 * x, source.m_width - 1),
+                std::min<size_t>(2 * x + 1, source.m_width - 1)
+            };
+            uint32_t weighted[3] = {0, 0, 0};
+            uint32_t plain[3] = {0, 0, 0};
+            uint32_t alpha = 0;
+            for (const auto row : rows) {
+                for (const auto column : columns) {
+                    const uint8_t* texel =
+                        source_data + (row * source.m_width + column) * 4;
+                    for (size_t channel = 0; channel < 3; channel++) {
+                        weighted[channel] += texel[channel] * texel[3];
+                        plain[channel] += texel[channel];
+                    }
+                    alpha += texel[3];
+                }
+            }
+            uint8_t* target_texel =
+                target_data + (y * target.m_width + x) * 4;
+            for (size_t channel = 0; channel < 3; channel++) {
+                target_texel[channel] =
+                    alpha > 0 ? (weighted[channel] + alpha / 2) / alpha
+                              : (plain[channel] + 2) / 4;
+            }
+            target_texel[3] = (alpha + 2) / 4;
+        }
+    });
+}
+
+bimg::ImageContainer*
+generate_image_mips(const bimg::ImageContainer* image)
+{
+    KAACORE_CHECK(
+        image->m_depth == 1 and image->m_numLayers == 1 and
+            not image->m_cubeMap,
+        "Mips can be generated only for 2D images."
+    );
+    bimg::ImageContainer* converted_image = nullptr;
+    if (image->m_format != bimg::TextureFormat::Enum::RGBA8) {
+        converted_image =
+            convert_image(image, bimg::TextureFormat::Enum::RGBA8);
+        image = converted_image;
+    }
+
+    bimg::ImageContainer* image_container = bimg::imageAlloc(
+        &texture_image_allocator, bimg::TextureFormat::Enum::RGBA8,
+        image->m_width, image->m_height, 1, 1, false, true
+    );
+    bimg::ImageMip source_mip;
+    bimg::imageGetRawData(
+        *image, 0, 0, image->m_data, image->m_size, source_mip
+    );
+    bimg::ImageMip previous_mip;
+    bimg::imageGetRawData(
+        *image_container, 0, 0, image_container->m_data,
+        image_container->m_size, previous_mip
+    );
+    std::memcpy(
+        const_cast<uint8_t*>(previous_mip.m_data), source_mip.m_data,
+        source_mip.m_size
+    );
+    for (uint8_t lod = 1; lod < image_container->m_numMips; lod++) {
+        bimg::ImageMip mip;
+        bimg::imageGetRawData(
+            *image_container, 0, lod, image_container->m_data,
+            image_container->m_size, mip
+        );
+        _downsample_rgba8(previous_mip, mip);
+        previous_mip = mip;
+    }
+
+    if (converted_image) {
+        bimg::imageFree(converted_image);
+    }
+    return image_container;
+}
+
+// Takes ownership of given image
+bimg::ImageContainer*
+_apply_texture_options(
+    bimg::ImageContainer* image_container, const TextureOptions& options
+)
+{
+    if (options.generate_mips and image_container->m_numMips == 1) {
+        auto mipped_image_container = generate_image_mips(image_container);
+        bimg::imageFree(image_container);
+        return mipped_image_container;
+    }
+    return image_container;
+}
+
+// Returns copy of image kept for querying pixels, nullptr if
+// nothing should be kept
+bimg::ImageContainer*
+_make_retained_image(
+    const bimg::ImageContainer* image, const ImageRetention retention
+)
+{
+    if (retention == ImageRetention::full or
+        retention == ImageRetention::none) {
+        return nullptr;
+    }
+    bimg::ImageContainer* converted_image = nullptr;
+    if (image->m_format != bimg::TextureFormat::Enum::RGBA8) {
+        converted_image =
+            convert_image(image, bimg::TextureFormat::Enum::RGBA8);
+        image = converted_image;
+    }
+    bimg::ImageMip source_mip;
+    bimg::imageGetRawData(
+        *image, 0, 0, image->m_data, image->m_size, source_mip
+    );
+
+    bimg::ImageContainer* retained_image;
+    if (retention == ImageRetention::downsampled) {
+        retained_image = bimg::imageAlloc(
+            &texture_image_allocator, bimg::TextureFormat::Enum::RGBA8,
+            std::max(image->m_width / 2, 1u), std::max(image->m_height / 2, 1u),
+            1, 1, false, false
+        );
+        bimg::ImageMip mip;
+        bimg::imageGetRawData(
+            *retained_image, 0, 0, retained_image->m_data,
+            retained_image->m_size, mip
+        );
+        _downsample_rgba8(source_mip, mip);
+    } else {
+        retained_image = bimg::imageAlloc(
+            &texture_image_allocator, bimg::TextureFormat::Enum::A8,
+            image->m_width, image->m_height, 1, 1, false, false
+        );
+        auto alpha = static_cast<uint8_t*>(retained_image->m_data);
+        const size_t pixels_count = size_t(image->m_width) * image->m_height;
+        for (size_t i = 0; i < pixels_count; i++) {
+            alpha[i] = source_mip.m_data[i * 4 + 3];
+        }
+    }
+
+    if (converted_image) {
+        bimg::imageFree(converted_image);
+    }
+    return retained_image;
+}
+
+bimg::ImageContainer*
+convert_image(
+    const bimg::ImageContainer* image, const bimg::TextureFormat::Enum format
+)
+{
+    KAACORE_CHECK(
+        not bimg::isCompressed(format),
+        "Can't convert image to compressed format: {}.", bimg::getName(format)
+    );
+    bimg::ImageContainer* image_container =
+        bimg::imageConvert(&texture_image_allocator, format, *image);
+    KAACORE_CHECK(
+        image_container != nullptr, "Failed to convert image from {} to {}.",
+        bimg::getName(image->m_format), bimg::getName(format)
+    );
+    return image_container;
+}
+
+bool
+is_texture_format_supported(const bimg::TextureFormat::Enum format)
+{
+    const auto caps = bgfx::getCaps();
+    return caps->formats[format] & (BGFX_CAPS_FORMAT_TEXTURE_2D |
+                                    BGFX_CAPS_FORMAT_TEXTURE_2D_EMULATED);
+}
+
+bool
+can_query_image(const bimg::ImageContainer* image)
+{
+    return not bimg::isCompressed(image->m_format);
+}
+
 glm::dvec4
 query_image_pixel(const bimg::ImageContainer* image, const glm::uvec2 position)
 {
+    KAACORE_CHECK(
+        can_query_image(image), "Can't query pixels of {} image.",
+        bimg::getName(image->m_format)
+    );
     const std::uint32_t bpp = bimg::getBitsPerPixel(image->m_format) / 8;
     std::uint8_t* ptr = reinterpret_cast<std::uint8_t*>(image->m_data);
     ptr += bpp * ((position.y * image->m_width) + position.x);
@@ -93,6 +429,17 @@ Texture::handle() const
     return this->_handle;
 }
 
+bgfx::TextureHandle
+Texture::bind_handle()
+{
+    this->_on_bind();
+    return this->_handle;
+}
+
+void
+Texture::_on_bind()
+{}
+
 bool
 Texture::can_query() const
 {
@@ -105,10 +452,14 @@ Texture::query_pixel(const glm::uvec2 position) const
     throw kaacore::exception{"Texture is unsuitable for querying!"};
 }
 
-MemoryTexture::MemoryTexture(bimg::ImageContainer* image_container)
+MemoryTexture::MemoryTexture(
+    bimg::ImageContainer* image_container, const TextureOptions& options
+)
+    : _sampler_flags(options.sampler_flags),
+      _image_retention(options.image_retention)
 {
-    this->image_container = std::shared_ptr<bimg::ImageContainer>(
-        image_container, _destroy_image_container
+    this->_set_image_container(
+        _apply_texture_options(image_container, options)
     );
 
     if (is_engine_initialized()) {
@@ -124,36 +475,89 @@ MemoryTexture::~MemoryTexture()
 }
 
 ResourceReference<MemoryTexture>
-MemoryTexture::create(bimg::ImageContainer* image_container)
+MemoryTexture::create(
+    bimg::ImageContainer* image_container, const TextureOptions& options
+)
 {
-    return std::shared_ptr<MemoryTexture>(new MemoryTexture(image_container));
+    return std::shared_ptr<MemoryTexture>(
+        new MemoryTexture(image_container, options)
+    );
 }
 
 glm::uvec2
 MemoryTexture::get_dimensions() const
 {
-    KAACORE_CHECK(this->image_container != nullptr, "Invalid image container.");
-    return {this->image_container->m_width, this->image_container->m_height};
+    return this->_dimensions;
 }
 
 bool
 MemoryTexture::can_query() const
 {
-    return true;
+    return this->_query_image_container and
+           can_query_image(this->_query_image_container.get());
 }
 
 glm::dvec4
 MemoryTexture::query_pixel(const glm::uvec2 position) const
 {
-    return query_image_pixel(this->image_container.get(), position);
+    const auto query_image = this->_query_image_container.get();
+    if (query_image == nullptr) {
+        throw kaacore::exception{"Texture image is not retained for querying!"};
+    }
+    // retained copy may have lower resolution
+    return query_image_pixel(
+        query_image,
+        {position.x * query_image->m_width / this->_dimensions.x,
+         position.y * query_image->m_height / this->_dimensions.y}
+    );
+}
+
+void
+MemoryTexture::_set_image_container(bimg::ImageContainer* image_container)
+{
+    KAACORE_CHECK(image_container != nullptr, "Invalid image container.");
+    this->image_container = _share_image_container(image_container);
+    this->_dimensions = {image_container->m_width, image_container->m_height};
+    if (this->_image_retention == ImageRetention::full) {
+        this->_query_image_container = this->image_container;
+    } else if (auto retained_image = _make_retained_image(
+                   image_container, this->_image_retention
+               )) {
+        this->_query_image_container = _share_image_container(retained_image);
+    } else {
+        this->_query_image_container.reset();
+    }
 }
 
 void
 MemoryTexture::_initialize()
 {
+    KAACORE_CHECK(
+        this->image_container != nullptr,
+        "Texture image was released after upload, it can't be recreated."
+    );
+    const auto format = this->image_container->m_format;
+    if (not is_texture_format_supported(format)) {
+        // e.g. ASTC on desktop GPUs, BC on mobile ones
+        KAACORE_LOG_WARN(
+            "Texture format {} is not supported by GPU, decoding it to RGBA8.",
+            bimg::getName(format)
+        );
+        this->image_container = _share_image_container(convert_image(
+            this->image_container.get(), bimg::TextureFormat::Enum::RGBA8
+        ));
+        if (this->_image_retention == ImageRetention::full) {
+            this->_query_image_container = this->image_container;
+        }
+    }
+    this->_uploaded_bytes = this->image_container->m_size;
     this->_handle = get_engine()->renderer->make_texture(
-        this->image_container, BGFX_SAMPLER_NONE
+        this->image_container, this->_sampler_flags
     );
+    if (this->_image_retention != ImageRetention::full) {
+        // renderer keeps the image alive until upload completes
+        this->image_container.reset();
+    }
     this->is_initialized = true;
 }
 
@@ -164,27 +568,339 @@ MemoryTexture::_uninitialize()
     this->is_initialized = false;
 }
 
-ImageTexture::ImageTexture(const std::string& path)
-    : path(path), MemoryTexture(load_image(path))
-{}
+UpdatableTexture::UpdatableTexture(bimg::ImageContainer* image_container)
+{
+    KAACORE_CHECK(
+        image_container->m_numMips == 1 and image_container->m_numLayers == 1,
+        "Updatable texture can't have mips or layers."
+    );
+    this->_image_container = _share_image_container(image_container);
+
+    if (is_engine_initialized()) {
+        this->_initialize();
+    }
+}
+
+UpdatableTexture::~UpdatableTexture()
+{
+    if (this->is_initialized) {
+        this->_uninitialize();
+    }
+}
+
+ResourceReference<UpdatableTexture>
+UpdatableTexture::create(bimg::ImageContainer* image_container)
+{
+    return std::shared_ptr<UpdatableTexture>(
+        new UpdatableTexture(image_container)
+    );
+}
+
+glm::uvec2
+UpdatableTexture::get_dimensions() const
+{
+    return {this->_image_container->m_width, this->_image_container->m_height};
+}
+
+bool
+UpdatableTexture::can_query() const
+{
+    return true;
+}
+
+glm::dvec4
+UpdatableTexture::query_pixel(const glm::uvec2 position) const
+{
+    return query_image_pixel(this->_image_container.get(), position);
+}
+
+void
+UpdatableTexture::update(
+    const glm::uvec2 position, const glm::uvec2 size, const uint8_t* data
+)
+{
+    const auto dimensions = this->get_dimensions();
+    KAACORE_CHECK(
+        position.x + size.x <= dimensions.x and
+            position.y + size.y <= dimensions.y,
+        "Updated region exceeds texture dimensions."
+    );
+    if (size.x == 0 or size.y == 0) {
+        return;
+    }
+
+    const uint32_t bpp =
+        bimg::getBitsPerPixel(this->_image_container->m_format) / 8;
+    auto pixels = reinterpret_cast<uint8_t*>(this->_image_container->m_data);
+    for (size_t row = 0; row < size.y; row++) {
+        std::memcpy(
+            pixels + ((position.y + row) * dimensions.x + position.x) * bpp,
+            data + (row * size.x * bpp), size.x * bpp
+        );
+    }
+
+    if (this->is_initialized) {
+        bgfx::updateTexture2D(
+            this->_handle, 0, 0, position.x, position.y, size.x, size.y,
+            bgfx::copy(data, size.x * size.y * bpp)
+        );
+    }
+}
+
+void
+UpdatableTexture::_initialize()
+{
+    const auto dimensions = this->get_dimensions();
+    const auto format =
+        bgfx::TextureFormat::Enum(this->_image_container->m_format);
+    // texture created without initial memory can be updated later
+    this->_handle = bgfx::createTexture2D(
+        dimensions.x, dimensions.y, false, 1, format, BGFX_SAMPLER_NONE
+    );
+    KAACORE_ASSERT(bgfx::isValid(this->_handle), "Failed to create texture.");
+    bgfx::updateTexture2D(
+        this->_handle, 0, 0, 0, 0, dimensions.x, dimensions.y,
+        bgfx::copy(
+            this->_image_container->m_data, this->_image_container->m_size
+        )
+    );
+    this->is_initialized = true;
+}
+
+void
+UpdatableTexture::_uninitialize()
+{
+    get_engine()->renderer->destroy_texture(this->_handle);
+    this->is_initialized = false;
+}
+
+ImageTexture::ImageTexture(
+    const std::string& path, const TextureOptions& options,
+    const bool asynchronous
+)
+    : path(path), _options(options)
+{
+    this->_sampler_flags = options.sampler_flags;
+    this->_image_retention = options.image_retention;
+    if (asynchronous) {
+        this->_start_loading();
+    } else {
+        this->_set_image_container(
+            _apply_texture_options(load_image(path), options)
+        );
+        this->_loaded = true;
+    }
+    if (is_engine_initialized()) {
+        this->_initialize();
+    }
+}
+
+ImageTexture::~ImageTexture()
+{
+    _pending_image_textures.erase(
+        std::remove(
+            _pending_image_textures.begin(), _pending_image_textures.end(),
+            this
+        ),
+        _pending_image_textures.end()
+    );
+    if (this->_pending_image.valid()) {
+        // decoded image has no other owner, so wait for it to free it
+        try {
+            _destroy_image_container(this->_pending_image.get());
+        } catch (const std::exception&) {
+        }
+    }
+    if (this->is_initialized) {
+        this->_uninitialize();
+    }
+}
+
+ResourceReference<ImageTexture>
+ImageTexture::load(const std::string& path, const TextureOptions& options)
+{
+    std::shared_ptr<ImageTexture> texture;
+    if ((texture = _image_textures_registry.get_resource(path))) {
+        texture->wait_until_loaded();
+        return texture;
+    }
+    texture =
+        std::shared_ptr<ImageTexture>(new ImageTexture(path, options, false));
+    _image_textures_registry.register_resource(path, texture);
+    return texture;
+}
 
 ResourceReference<ImageTexture>
-ImageTexture::load(const std::string& path)
+ImageTexture::load_async(
+    const std::string& path, const TextureOptions& options
+)
 {
     std::shared_ptr<ImageTexture> texture;
     if ((texture = _image_textures_registry.get_resource(path))) {
         return texture;
     }
-    texture = std::shared_ptr<ImageTexture>(new ImageTexture(path));
+    texture =
+        std::shared_ptr<ImageTexture>(new ImageTexture(path, options, true));
     _image_textures_registry.register_resource(path, texture);
     return texture;
 }
 
+bool
+ImageTexture::is_loaded() const
+{
+    return this->_loaded;
+}
+
+bool
+ImageTexture::is_resident() const
+{
+    return this->_resident;
+}
+
+void
+ImageTexture::wait_until_loaded()
+{
+    if (this->_load_error) {
+        std::rethrow_exception(this->_load_error);
+    }
+    if (this->_evicted and not this->_pending_image.valid()) {
+        this->_reload();
+    }
+    if (this->_pending_image.valid()) {
+        this->_finish_loading();
+    }
+}
+
+bool
+ImageTexture::can_query() const
+{
+    return this->is_loaded() and MemoryTexture::can_query();
+}
+
+glm::dvec4
+ImageTexture::query_pixel(const glm::uvec2 position) const
+{
+    KAACORE_CHECK(
+        this->is_loaded(), "Image is not loaded yet: {}.", this->path
+    );
+    return MemoryTexture::query_pixel(position);
+}
+
+void
+ImageTexture::_start_loading()
+{
+    this->_pending_image = get_worker_pool().submit(
+        [path = this->path, options = this->_options]() {
+            return _apply_texture_options(load_image(path), options);
+        }
+    );
+    _pending_image_textures.push_back(this);
+}
+
+void
+ImageTexture::_reload()
+{
+    KAACORE_LOG_DEBUG("Reloading evicted texture: {}", this->path);
+    _textures_residency.reloads++;
+    if (this->image_container) {
+        // retained image is uploaded again right away
+        this->_initialize();
+    } else {
+        this->_start_loading();
+    }
+}
+
+void
+ImageTexture::_finish_loading()
+{
+    auto pending_image = std::move(this->_pending_image);
+    bimg::ImageContainer* image_container;
+    try {
+        image_container = pending_image.get();
+    } catch (...) {
+        // kept for later waits and loads, failed load is not retried
+        this->_load_error = std::current_exception();
+        throw;
+    }
+    this->_set_image_container(image_container);
+    this->_loaded = true;
+    if (this->is_initialized) {
+        // placeholder handle is not owned, so there is nothing to destroy
+        this->_initialize();
+    }
+}
+
+void
+ImageTexture::_evict()
+{
+    KAACORE_ASSERT(this->_resident, "Texture is not resident: {}.", this->path);
+    KAACORE_LOG_DEBUG("Evicting texture: {}", this->path);
+    _textures_residency.resident_bytes -= this->_uploaded_bytes;
+    _textures_residency.resident_textures.erase(this->_residency_position);
+    _textures_residency.evictions++;
+    this->_resident = false;
+    // images in RAM are kept according to retention policy
+    get_engine()->renderer->destroy_texture(this->_handle);
+    this->_handle = get_engine()->renderer->default_texture->handle();
+    this->_evicted = true;
+}
+
+void
+ImageTexture::_on_bind()
+{
+    this->_last_bind_frame = _textures_residency.frame;
+    if (this->_resident) {
+        auto& resident_textures = _textures_residency.resident_textures;
+        resident_textures.splice(
+            resident_textures.begin(), resident_textures,
+            this->_residency_position
+        );
+    } else if (this->_evicted and not this->_pending_image.valid() and
+               not this->_load_error) {
+        this->_reload();
+    }
+}
+
 void
 ImageTexture::_initialize()
 {
+    if (not this->is_loaded() or this->image_container == nullptr) {
+        // image is still decoded or it was released after previous
+        // upload, then it's loaded from file again when drawn
+        this->_handle = get_engine()->renderer->default_texture->handle();
+        this->is_initialized = true;
+        return;
+    }
     MemoryTexture::_initialize();
+    this->_evicted = false;
     bgfx::setName(this->_handle, this->path.c_str());
+
+    auto& resident_textures = _textures_residency.resident_textures;
+    resident_textures.push_front(this);
+    this->_residency_position = resident_textures.begin();
+    this->_resident = true;
+    // recently loaded texture shouldn't be evicted before being drawn
+    this->_last_bind_frame = _textures_residency.frame;
+    _textures_residency.resident_bytes += this->_uploaded_bytes;
+}
+
+void
+ImageTexture::_uninitialize()
+{
+    if (this->_resident) {
+        _textures_residency.resident_bytes -= this->_uploaded_bytes;
+        _textures_residency.resident_textures.erase(this->_residency_position);
+        this->_resident = false;
+    }
+    if (not this->is_loaded() or this->_evicted) {
+        // placeholder handle is not owned
+        this->is_initialized = false;
+        return;
+    }
+    MemoryTexture::_uninitialize();
+    // released image is decoded again when drawn after
+    // engine is initialized again
+    this->_evicted = true;
 }
 
 } // namespace kaacore
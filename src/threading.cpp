@@ -1,5 +1,12 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
 #include <mutex>
 
+#include "kaacore/exceptions.h"
+#include "kaacore/tracing.h"
+
 #include "kaacore/threading.h"
 
 namespace kaacore {
@@ -14,4 +21,198 @@ SyncedSyscallQueue::finalize_calls()
     this->_queued_functions.clear();
 }
 
+ThreadPool::ThreadPool(const size_t threads_count)
+{
+    KAACORE_LOG_DEBUG("Starting thread pool with {} threads.", threads_count);
+    this->_threads.reserve(threads_count);
+    for (size_t i = 0; i < threads_count; i++) {
+        this->_threads.emplace_back([this]() { this->_worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock{this->_tasks_mutex};
+        this->_stopping = true;
+    }
+    this->_tasks_condition.notify_all();
+    for (auto& thread : this->_threads) {
+        thread.join();
+    }
+}
+
+size_t
+ThreadPool::threads_count() const
+{
+    return this->_threads.size();
+}
+
+void
+ThreadPool::_worker_loop()
+{
+    KAACORE_TRACE_THREAD_NAME("worker");
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock{this->_tasks_mutex};
+            this->_tasks_condition.wait(lock, [this] {
+                return this->_stopping or not this->_tasks.empty();
+            });
+            if (this->_tasks.empty()) {
+                return;
+            }
+            task = std::move(this->_tasks.front());
+            this->_tasks.pop_front();
+        }
+        KAACORE_TRACE_SCOPE("threading", "task");
+        task();
+    }
+}
+
+struct _ParallelForState {
+    std::atomic<size_t> next_index{0};
+    size_t count;
+    const std::function<void(size_t)>* func;
+    std::exception_ptr exception;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t active_helpers = 0;
+    // set once calling thread is done, helpers started later
+    // must not touch `func` anymore
+    bool closed = false;
+
+    void run()
+    {
+        try {
+            size_t index;
+            while ((index = this->next_index++) < this->count) {
+                (*this->func)(index);
+            }
+        } catch (...) {
+            std::lock_guard lock{this->mutex};
+            if (not this->exception) {
+                this->exception = std::current_exception();
+            }
+            this->next_index = this->count;
+        }
+    }
+};
+
+void
+ThreadPool::parallel_for(
+    const size_t count, const std::function<void(size_t)>& func
+)
+{
+    if (count == 0) {
+        return;
+    }
+    auto state = std::make_shared<_ParallelForState>();
+    state->count = count;
+    state->func = &func;
+
+    const size_t helpers_count = std::min(this->threads_count(), count - 1);
+    if (helpers_count > 0) {
+        {
+            std::lock_guard lock{this->_tasks_mutex};
+            for (size_t i = 0; i < helpers_count; i++) {
+                this->_tasks.emplace_back([state]() {
+                    {
+                        std::lock_guard state_lock{state->mutex};
+                        if (state->closed) {
+                            return;
+                        }
+                        state->active_helpers++;
+                    }
+                    state->run();
+                    {
+                        std::lock_guard state_lock{state->mutex};
+                        state->active_helpers--;
+                    }
+                    state->condition.notify_one();
+                });
+            }
+        }
+        this->_tasks_condition.notify_all();
+    }
+
+    state->run();
+    {
+        std::unique_lock lock{state->mutex};
+        state->closed = true;
+        state->condition.wait(lock, [&state] {
+            return state->active_helpers == 0;
+        });
+    }
+    if (state->exception) {
+        std::rethrow_exception(state->exception);
+    }
+}
+
+ThreadPool&
+get_worker_pool()
+{
+    static ThreadPool worker_pool{
+        std::max(std::thread::hardware_concurrency(), 2u) - 1
+    };
+    return worker_pool;
+}
+
+SpscRingBuffer::SpscRingBuffer(const size_t capacity) : _buffer(capacity)
+{
+    KAACORE_CHECK(capacity > 0, "Ring buffer capacity must be positive.");
+}
+
+size_t
+SpscRingBuffer::capacity() const
+{
+    return this->_buffer.size();
+}
+
+size_t
+SpscRingBuffer::free_space() const
+{
+    return this->capacity() - (this->_write_position.load() -
+                               this->_read_position.load());
+}
+
+size_t
+SpscRingBuffer::write(const std::byte* data, const size_t size)
+{
+    const size_t write_position =
+        this->_write_position.load(std::memory_order_relaxed);
+    const size_t written = std::min(size, this->free_space());
+    const size_t offset = write_position % this->capacity();
+    const size_t head_size = std::min(written, this->capacity() - offset);
+    std::memcpy(this->_buffer.data() + offset, data, head_size);
+    std::memcpy(this->_buffer.data(), data + head_size, written - head_size);
+    this->_write_position.store(
+        write_position + written, std::memory_order_release
+    );
+    return written;
+}
+
+size_t
+SpscRingBuffer::available() const
+{
+    return this->_write_position.load() - this->_read_position.load();
+}
+
+size_t
+SpscRingBuffer::read(std::byte* data, const size_t size)
+{
+    const size_t read_position =
+        this->_read_position.load(std::memory_order_relaxed);
+    const size_t read = std::min(size, this->available());
+    const size_t offset = read_position % this->capacity();
+    const size_t head_size = std::min(read, this->capacity() - offset);
+    std::memcpy(data, this->_buffer.data() + offset, head_size);
+    std::memcpy(data + head_size, this->_buffer.data(), read - head_size);
+    this->_read_position.store(
+        read_position + read, std::memory_order_release
+    );
+    return read;
+}
+
 } // namespace kaacore
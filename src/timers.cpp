@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <utility>
 #include <unordered_map>
 
 #include "kaacore/engine.h"
@@ -59,96 +60,124 @@ TimersManager::TimersManager() : _scene(nullptr) {}
 
 TimersManager::TimersManager(Scene* const scene) : _scene(scene) {}
 
+TimersManager::~TimersManager()
+{
+    auto awaiting_state = this->_awaiting_timers.exchange(nullptr);
+    while (awaiting_state) {
+        delete std::exchange(awaiting_state, awaiting_state->next);
+    }
+}
+
 TimersManager::_InvocationInstance::_InvocationInstance(
     TimerId invocation_id, Duration interval, TimePoint triggered_at,
-    std::weak_ptr<_TimerState>&& state
+    uint64_t sequence, std::weak_ptr<_TimerState>&& state
 )
-    : invocation_id(invocation_id), interval(interval),
-      triggered_at(triggered_at), state(state)
-{}
+    : invocation_id(invocation_id), state(std::move(state))
+{
+    this->reschedule(interval, triggered_at, sequence);
+}
+
+void
+TimersManager::_InvocationInstance::reschedule(
+    const Duration interval, const TimePoint triggered_at,
+    const uint64_t sequence
+)
+{
+    this->interval = interval;
+    this->fire_at = triggered_at +
+                    std::chrono::duration_cast<HighPrecisionDuration>(interval);
+    this->sequence = sequence;
+}
 
 void
 TimersManager::start(const Duration interval, Timer& timer)
 {
-    {
-        std::unique_lock<std::mutex> lock{this->_lock};
-        auto state = timer._state;
-        auto invocation_id =
-            this->_last_id.fetch_add(1, std::memory_order_relaxed);
-        state->id = invocation_id;
-        state->is_running.store(true, std::memory_order_release);
-        this->_awaiting_timers.data.emplace_back(
-            invocation_id, interval, state
-        );
+    auto& state = timer._state;
+    auto invocation_id =
+        this->_last_id.fetch_add(1, std::memory_order_relaxed);
+    state->id.store(invocation_id, std::memory_order_relaxed);
+    state->is_running.store(true, std::memory_order_release);
+
+    auto awaiting_state =
+        new _AwaitingState{invocation_id, interval, state, nullptr};
+    awaiting_state->next =
+        this->_awaiting_timers.load(std::memory_order_relaxed);
+    while (not this->_awaiting_timers.compare_exchange_weak(
+        awaiting_state->next, awaiting_state, std::memory_order_release,
+        std::memory_order_relaxed
+    )) {
     }
-    this->_awaiting_timers.is_dirty.store(true, std::memory_order_release);
 }
 
 void
 TimersManager::process(const HighPrecisionDuration dt)
 {
-    if (this->_awaiting_timers.is_dirty.load(std::memory_order_acquire)) {
+    // take all awaiting timers at once, consumer never pops single nodes
+    // so the stack is not prone to ABA problem
+    auto awaiting_state =
+        this->_awaiting_timers.exchange(nullptr, std::memory_order_acquire);
+    if (awaiting_state) {
+        // stack holds timers in reverse order of starting
+        _AwaitingState* reversed = nullptr;
+        while (awaiting_state) {
+            auto next = awaiting_state->next;
+            awaiting_state->next = reversed;
+            reversed = awaiting_state;
+            awaiting_state = next;
+        }
         auto now = this->time_point();
-        {
-            std::unique_lock<std::mutex> lock{this->_lock};
-            for (auto& awaiting_state : this->_awaiting_timers.data) {
-                auto& [invocation_id, interval, weak_state] = awaiting_state;
-                this->_queue.data.emplace_back(
-                    invocation_id, interval, now, std::move(weak_state)
-                );
-            }
-            this->_awaiting_timers.data.clear();
+        while (reversed) {
+            this->_queue.emplace_back(
+                reversed->invocation_id, reversed->interval, now,
+                this->_sequence_counter++, std::move(reversed->state)
+            );
+            std::push_heap(this->_queue.begin(), this->_queue.end());
+            delete std::exchange(reversed, reversed->next);
         }
-        this->_queue.is_dirty = true;
-        this->_awaiting_timers.is_dirty.store(false, std::memory_order_release);
     }
 
     this->_dt_accumulator += dt;
 
-    if (this->_queue.is_dirty) {
-        std::sort(
-            this->_queue.data.begin(), this->_queue.data.end(),
-            [](const auto& lhs, const auto& rhs) -> bool {
-                return lhs.fire_at() > rhs.fire_at();
-            }
-        );
-        this->_queue.is_dirty = false;
-    }
-
     auto now = this->time_point();
-    for (auto it = this->_queue.data.rbegin(); it != this->_queue.data.rend();
-         ++it) {
-        if (it->fire_at() > now) {
-            break;
-        }
+    while (not this->_queue.empty() and this->_queue.front().fire_at <= now) {
+        std::pop_heap(this->_queue.begin(), this->_queue.end());
+        auto& invocation = this->_queue.back();
 
-        auto invocation_id = it->invocation_id;
-        auto state = it->state.lock();
+        auto state = invocation.state.lock();
         if (not state) {
             // timer deleted
-            this->_queue.data.pop_back();
+            this->_queue.pop_back();
             continue;
         }
 
         if (not state->is_running.load(std::memory_order_acquire) or
-            state->id != invocation_id) {
+            state->id.load(std::memory_order_relaxed) !=
+                invocation.invocation_id) {
             // timer outdated
-            this->_queue.data.pop_back();
+            this->_queue.pop_back();
             continue;
         }
 
-        struct TimerContext context = {it->interval, this->_scene};
+        struct TimerContext context = {invocation.interval, this->_scene};
         auto next_interval = state->callback(context);
         if (not(next_interval > 0.s)) {
-            this->_queue.data.pop_back();
+            this->_queue.pop_back();
             state->is_running.store(false, std::memory_order_release);
             continue;
         }
 
-        it->triggered_at = now;
-        it->interval = next_interval;
-        this->_queue.is_dirty = true;
+        // pushed back to the heap after the loop, so intervals shorter
+        // than clock resolution can't fire more than once per frame
+        invocation.reschedule(next_interval, now, this->_sequence_counter++);
+        this->_rescheduled.push_back(std::move(invocation));
+        this->_queue.pop_back();
+    }
+
+    for (auto& invocation : this->_rescheduled) {
+        this->_queue.push_back(std::move(invocation));
+        std::push_heap(this->_queue.begin(), this->_queue.end());
     }
+    this->_rescheduled.clear();
 }
 
 TimePoint
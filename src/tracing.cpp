@@ -0,0 +1,214 @@
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "kaacore/files.h"
+#include "kaacore/log.h"
+
+#include "kaacore/tracing.h"
+
+namespace kaacore {
+
+#if KAACORE_TRACING
+
+struct _TraceThreadBuffer {
+    uint32_t thread_id;
+    std::string thread_name;
+    // only contended while trace is dumped
+    std::mutex lock;
+    std::vector<TraceEvent> events;
+    // total number of recorded events, wrapped when indexing
+    uint64_t recorded_count = 0;
+};
+
+inline int64_t
+_trace_timestamp()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()
+    )
+        .count();
+}
+
+struct _Tracer {
+    std::mutex lock;
+    // buffers of exited threads are kept, so their events can be dumped
+    std::vector<std::unique_ptr<_TraceThreadBuffer>> thread_buffers;
+    const int64_t start_timestamp = _trace_timestamp();
+};
+
+_Tracer&
+_get_tracer()
+{
+    // never destroyed, threads can still record events at exit
+    static auto tracer = new _Tracer;
+    return *tracer;
+}
+
+_TraceThreadBuffer&
+_get_trace_thread_buffer()
+{
+    thread_local _TraceThreadBuffer* thread_buffer = nullptr;
+    if (not thread_buffer) {
+        auto& tracer = _get_tracer();
+        auto buffer = std::make_unique<_TraceThreadBuffer>();
+        // allocated up front, so recording never allocates
+        buffer->events.resize(trace_thread_buffer_size);
+        std::lock_guard lock{tracer.lock};
+        buffer->thread_id = tracer.thread_buffers.size() + 1;
+        thread_buffer = buffer.get();
+        tracer.thread_buffers.push_back(std::move(buffer));
+    }
+    return *thread_buffer;
+}
+
+void
+trace_event(
+    const TraceEventPhase phase, const char* category, const char* name,
+    const char* arg_name, const double arg_value
+)
+{
+    auto& buffer = _get_trace_thread_buffer();
+    const auto timestamp = _trace_timestamp();
+    std::lock_guard lock{buffer.lock};
+    buffer.events[buffer.recorded_count % buffer.events.size()] = {
+        category, name, arg_name, arg_value, timestamp, phase
+    };
+    buffer.recorded_count++;
+}
+
+void
+set_trace_thread_name(const std::string& name)
+{
+    auto& buffer = _get_trace_thread_buffer();
+    std::lock_guard lock{buffer.lock};
+    buffer.thread_name = name;
+}
+
+TraceScope::TraceScope(
+    const char* category, const char* name, const char* arg_name,
+    const double arg_value
+)
+    : _category(category), _name(name)
+{
+    trace_event(TraceEventPhase::begin, category, name, arg_name, arg_value);
+}
+
+TraceScope::~TraceScope()
+{
+    trace_event(TraceEventPhase::end, this->_category, this->_name);
+}
+
+std::string
+_escape_json(const std::string& text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const char c : text) {
+        if (c == '"' or c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += fmt::format("\\u{:04x}", int(c));
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+#endif
+
+std::string
+dump_trace_json()
+{
+    std::string trace = "{\"traceEvents\":[";
+#if KAACORE_TRACING
+    auto& tracer = _get_tracer();
+    std::lock_guard lock{tracer.lock};
+    bool first_event = true;
+    auto append_event = [&trace, &first_event](const std::string& event) {
+        if (not first_event) {
+            trace += ',';
+        }
+        trace += "\n";
+        trace += event;
+        first_event = false;
+    };
+
+    for (auto& buffer : tracer.thread_buffers) {
+        std::lock_guard buffer_lock{buffer->lock};
+        if (not buffer->thread_name.empty()) {
+            append_event(fmt::format(
+                "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                "\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                buffer->thread_id, _escape_json(buffer->thread_name)
+            ));
+        }
+        const size_t capacity = buffer->events.size();
+        const uint64_t first_index = buffer->recorded_count > capacity
+                                         ? buffer->recorded_count - capacity
+                                         : 0;
+        // begin events of oldest scopes could be already overwritten
+        size_t depth = 0;
+        for (auto i = first_index; i < buffer->recorded_count; i++) {
+            const auto& event = buffer->events[i % capacity];
+            if (event.phase == TraceEventPhase::end) {
+                if (depth == 0) {
+                    continue;
+                }
+                depth--;
+            } else {
+                depth++;
+            }
+            std::string args;
+            if (event.arg_name) {
+                args = fmt::format(
+                    ",\"args\":{{\"{}\":{}}}", _escape_json(event.arg_name),
+                    event.arg_value
+                );
+            }
+            append_event(fmt::format(
+                "{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"{}\",\"ts\":{:.3f},"
+                "\"pid\":1,\"tid\":{}{}}}",
+                _escape_json(event.name), _escape_json(event.category),
+                static_cast<char>(event.phase),
+                (event.timestamp - tracer.start_timestamp) / 1000.,
+                buffer->thread_id, args
+            ));
+        }
+    }
+#endif
+    trace += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return trace;
+}
+
+bool
+write_trace(const std::string& path)
+{
+    const auto trace = dump_trace_json();
+    if (not write_file(
+            path, reinterpret_cast<const std::byte*>(trace.data()),
+            trace.size()
+        )) {
+        return false;
+    }
+    KAACORE_LOG_INFO("Trace written to: {}", path);
+    return true;
+}
+
+void
+clear_trace()
+{
+#if KAACORE_TRACING
+    auto& tracer = _get_tracer();
+    std::lock_guard lock{tracer.lock};
+    for (auto& buffer : tracer.thread_buffers) {
+        std::lock_guard buffer_lock{buffer->lock};
+        buffer->recorded_count = 0;
+    }
+#endif
+}
+
+} // namespace kaacore
@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <deque>
 #include <list>
+#include <mutex>
 #include <optional>
+#include <unordered_map>
 
 #include <spdlog/fmt/fmt.h>
 
@@ -7,11 +11,53 @@
 #include "kaacore/exceptions.h"
 #include "kaacore/log.h"
 #include "kaacore/nodes.h"
+#include "kaacore/scenes.h"
 
 #include "kaacore/transitions.h"
 
 namespace kaacore {
 
+struct _TransitionSlotsRegistry {
+    std::mutex lock;
+    // deque keeps references to names valid while registry grows
+    std::deque<std::string> names{default_transition_name};
+    std::unordered_map<std::string, NodeTransitionSlot> slots{
+        {default_transition_name, default_transition_slot}
+    };
+};
+
+_TransitionSlotsRegistry&
+get_transition_slots_registry()
+{
+    static _TransitionSlotsRegistry registry;
+    return registry;
+}
+
+NodeTransitionSlot
+get_transition_slot(const std::string& name)
+{
+    if (name == default_transition_name) {
+        return default_transition_slot;
+    }
+    auto& registry = get_transition_slots_registry();
+    std::lock_guard lock{registry.lock};
+    auto [it, inserted] =
+        registry.slots.try_emplace(name, registry.names.size());
+    if (inserted) {
+        registry.names.push_back(name);
+    }
+    return it->second;
+}
+
+const std::string&
+get_transition_slot_name(const NodeTransitionSlot slot)
+{
+    auto& registry = get_transition_slots_registry();
+    std::lock_guard lock{registry.lock};
+    KAACORE_CHECK(slot < registry.names.size(), "Unknown transition slot.");
+    return registry.names[slot];
+}
+
 TransitionWarping::TransitionWarping(uint32_t loops, bool back_and_forth)
     : loops(loops), back_and_forth(back_and_forth)
 {
@@ -76,6 +122,12 @@ NodeTransitionBase::prepare_state(NodePtr node) const
     return nullptr;
 }
 
+std::optional<BatchedTransitionParams>
+NodeTransitionBase::batched_params(NodePtr node) const
+{
+    return std::nullopt;
+}
+
 NodeTransitionCustomizable::NodeTransitionCustomizable() {}
 
 NodeTransitionCustomizable::NodeTransitionCustomizable(
@@ -487,6 +539,11 @@ NodeTransitionRunner::NodeTransitionRunner(
     this->setup(transition);
 }
 
+NodeTransitionRunner::~NodeTransitionRunner()
+{
+    this->_unbatch();
+}
+
 NodeTransitionRunner&
 NodeTransitionRunner::operator=(const NodeTransitionHandle& transition)
 {
@@ -497,6 +554,7 @@ NodeTransitionRunner::operator=(const NodeTransitionHandle& transition)
 void
 NodeTransitionRunner::setup(const NodeTransitionHandle& transition)
 {
+    this->_unbatch();
     this->transition_handle = transition;
     this->transition_state.reset();
     this->transition_state_prepared = false;
@@ -509,6 +567,20 @@ NodeTransitionRunner::step(NodePtr node, const HighPrecisionDuration dt)
     KAACORE_ASSERT(bool(*this), "Invalid internal stet of transition runner.");
 
     if (not this->transition_state_prepared) {
+        Scene* scene = node->scene();
+        std::optional<BatchedTransitionParams> params;
+        if (scene) {
+            params = this->transition_handle->batched_params(node);
+        }
+        if (params) {
+            // from now on transition will be processed by scene,
+            // after all nodes are stepped
+            scene->batched_transitions.add(
+                node.get(), this, *params, this->current_time
+            );
+            this->transition_state_prepared = true;
+            return false;
+        }
         this->transition_state = this->transition_handle->prepare_state(node);
         this->transition_state_prepared = true;
     }
@@ -524,47 +596,118 @@ NodeTransitionRunner::step(NodePtr node, const HighPrecisionDuration dt)
     return false;
 }
 
+bool
+NodeTransitionRunner::is_batched() const
+{
+    return this->_batch_manager != nullptr;
+}
+
+HighPrecisionDuration
+NodeTransitionRunner::elapsed_time() const
+{
+    if (this->_batch_manager) {
+        return this->_batch_manager->elapsed_time(this);
+    }
+    return this->current_time;
+}
+
+void
+NodeTransitionRunner::elapsed_time(const HighPrecisionDuration elapsed_time)
+{
+    if (this->_batch_manager) {
+        this->_batch_manager->elapsed_time(this, elapsed_time);
+    } else {
+        this->current_time = elapsed_time;
+    }
+}
+
 NodeTransitionRunner::operator bool() const
 {
     return bool(this->transition_handle);
 }
 
+void
+NodeTransitionRunner::_unbatch()
+{
+    if (this->_batch_manager) {
+        this->_batch_manager->remove(this);
+    }
+}
+
+NodeTransitionsManager::_RunnersVector::iterator
+NodeTransitionsManager::_find_runner(const NodeTransitionSlot slot)
+{
+    return std::find_if(
+        this->_runners.begin(), this->_runners.end(),
+        [slot](const auto& entry) { return entry.first == slot; }
+    );
+}
+
+void
+NodeTransitionsManager::_apply_update(
+    const NodeTransitionSlot slot, const NodeTransitionHandle& transition
+)
+{
+    auto it = this->_find_runner(slot);
+    if (transition) {
+        if (it != this->_runners.end()) {
+            *it->second = transition;
+        } else {
+            this->_runners.emplace_back(
+                slot, std::make_unique<NodeTransitionRunner>(transition)
+            );
+        }
+    } else if (it != this->_runners.end()) {
+        this->_runners.erase(it);
+    }
+}
+
 NodeTransitionHandle
-NodeTransitionsManager::get(const std::string& name)
+NodeTransitionsManager::get(const NodeTransitionSlot slot)
 {
     if (not this->_enqueued_updates.empty()) {
         for (auto it = this->_enqueued_updates.rbegin();
              it != this->_enqueued_updates.rend(); it++) {
-            const auto& [q_name, q_transition] = *it;
-            if (name == q_name) {
+            const auto& [q_slot, q_transition] = *it;
+            if (slot == q_slot) {
                 return q_transition;
             }
         }
     }
 
-    const auto it = this->_transitions_map.find(name);
-    if (it != this->_transitions_map.end()) {
-        return std::get<NodeTransitionRunner>(*it).transition_handle;
+    const auto it = this->_find_runner(slot);
+    if (it != this->_runners.end()) {
+        return it->second->transition_handle;
     }
     return NodeTransitionHandle();
 }
 
+NodeTransitionHandle
+NodeTransitionsManager::get(const std::string& name)
+{
+    return this->get(get_transition_slot(name));
+}
+
 void
 NodeTransitionsManager::set(
-    const std::string& name, const NodeTransitionHandle& transition
+    const NodeTransitionSlot slot, const NodeTransitionHandle& transition
 )
 {
     if (not this->_is_processing) {
-        if (transition) {
-            this->_transitions_map.insert_or_assign(name, transition);
-        } else {
-            this->_transitions_map.erase(name);
-        }
+        this->_apply_update(slot, transition);
     } else {
-        this->_enqueued_updates.emplace_back(name, transition);
+        this->_enqueued_updates.emplace_back(slot, transition);
     }
 }
 
+void
+NodeTransitionsManager::set(
+    const std::string& name, const NodeTransitionHandle& transition
+)
+{
+    this->set(get_transition_slot(name), transition);
+}
+
 void
 NodeTransitionsManager::step(NodePtr node, const HighPrecisionDuration dt)
 {
@@ -576,8 +719,11 @@ NodeTransitionsManager::step(NodePtr node, const HighPrecisionDuration dt)
         "Invalid internal state of transition manager."
     );
     this->_is_processing = true;
-    for (auto& [name, runner] : this->_transitions_map) {
-        bool finished = runner.step(node, dt);
+    for (auto& [slot, runner] : this->_runners) {
+        if (runner->is_batched()) {
+            continue;
+        }
+        bool finished = runner->step(node, dt);
         if (node.is_marked_to_delete()) {
             return;
         }
@@ -585,29 +731,48 @@ NodeTransitionsManager::step(NodePtr node, const HighPrecisionDuration dt)
             // if transition is finished destroy it's runner,
             // use `_enqueued_updates` to not break for iteration.
             this->_enqueued_updates.emplace(
-                this->_enqueued_updates.begin(), name, NodeTransitionHandle()
+                this->_enqueued_updates.begin(), slot, NodeTransitionHandle()
             );
         }
     }
 
     if (not this->_enqueued_updates.empty()) {
-        for (const auto& [name, transition] : this->_enqueued_updates) {
-            if (transition) {
-                this->_transitions_map.insert_or_assign(name, transition);
-            } else {
-                this->_transitions_map.erase(name);
-            }
+        for (const auto& [slot, transition] : this->_enqueued_updates) {
+            this->_apply_update(slot, transition);
         }
         this->_enqueued_updates.clear();
     }
     this->_is_processing = false;
 }
 
-NodeTransitionsManager::operator bool() const
+void
+NodeTransitionsManager::_remove_runner(const NodeTransitionRunner* runner)
 {
-    return not(
-        this->_transitions_map.empty() and this->_enqueued_updates.empty()
+    auto it = std::find_if(
+        this->_runners.begin(), this->_runners.end(),
+        [runner](const auto& entry) { return entry.second.get() == runner; }
+    );
+    KAACORE_ASSERT(
+        it != this->_runners.end(),
+        "Invalid internal state of transition manager."
     );
+    if (not this->_is_processing) {
+        this->_runners.erase(it);
+    } else {
+        this->_enqueued_updates.emplace_back(it->first, NodeTransitionHandle());
+    }
+}
+
+bool
+NodeTransitionsManager::_requires_stepping() const
+{
+    return this->_runners.size() > this->_batched_runners_count or
+           not this->_enqueued_updates.empty();
+}
+
+NodeTransitionsManager::operator bool() const
+{
+    return not(this->_runners.empty() and this->_enqueued_updates.empty());
 }
 
 } // namespace kaacore
@@ -193,7 +193,7 @@ Sampler::_texture_handle()
             if constexpr (std::is_same_v<T, bgfx::TextureHandle>) {
                 return variant;
             } else if constexpr (std::is_same_v<T, std::shared_ptr<Texture>>) {
-                return variant->handle();
+                return variant->bind_handle();
             }
         },
         this->_value
@@ -201,9 +201,9 @@ Sampler::_texture_handle()
 }
 
 void
-Sampler::_set(const Texture* texture, const uint8_t stage, const uint32_t flags)
+Sampler::_set(Texture* texture, const uint8_t stage, const uint32_t flags)
 {
-    this->_value = texture->handle();
+    this->_value = texture->bind_handle();
     this->_stage = stage;
     this->_flags = flags;
 }
@@ -0,0 +1,83 @@
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "kaacore/audio.h"
+#include "kaacore/exceptions.h"
+
+#include "runner.h"
+
+TEST_CASE("test_sound_bank", "[audio]")
+{
+    auto engine = initialize_testing_engine();
+    kaacore::SoundBank sound_bank;
+    REQUIRE(sound_bank.progress() == 1.);
+
+    // failed loads count as finished
+    sound_bank.preload(
+        {"missing_sound_1.wav", "missing_sound_2.wav", "missing_sound_1.wav"}
+    );
+    REQUIRE(sound_bank.size() == 2);
+    sound_bank.wait_until_loaded();
+    REQUIRE(sound_bank.is_loaded());
+    REQUIRE(sound_bank.loaded_count() == 2);
+    REQUIRE(sound_bank.progress() == 1.);
+    REQUIRE_THROWS_AS(sound_bank.get("other_sound.wav"), kaacore::exception);
+
+    auto& audio_manager = engine->audio_manager;
+    REQUIRE(audio_manager->sound_cache_usage() == 0);
+    audio_manager->sound_cache_budget(1024);
+    REQUIRE(audio_manager->sound_cache_budget() == 1024);
+    audio_manager->sound_cache_budget(kaacore::default_sound_cache_budget);
+}
+
+TEST_CASE("test_sound_voices", "[audio]")
+{
+    auto engine = initialize_testing_engine();
+    auto sound = kaacore::Sound::load("missing_sound.wav");
+    REQUIRE(sound.max_voices() == 0);
+    REQUIRE(sound.priority() == 0);
+    sound.max_voices(4);
+    sound.priority(-1);
+    REQUIRE(sound.max_voices() == 4);
+    REQUIRE(sound.priority() == -1);
+
+    // incorrectly loaded sounds don't take voices
+    sound.play();
+    sound.play();
+    const auto stats = engine->audio_manager->voices_stats();
+    REQUIRE(stats.active_voices == 0);
+    REQUIRE(stats.stolen_voices == 0);
+    REQUIRE(stats.dropped_voices == 0);
+    REQUIRE(stats.deduplicated_voices == 0);
+}
+
+TEST_CASE("test_select_voice_to_steal", "[audio]")
+{
+    auto engine = initialize_testing_engine();
+    auto make_channel_state = [](const int priority, const uint64_t order) {
+        kaacore::_ChannelState channel_state{};
+        channel_state.current_sound = kaacore::Sound::load("missing_sound.wav");
+        channel_state.current_sound.priority(priority);
+        channel_state.start_order = order;
+        return channel_state;
+    };
+
+    std::vector<kaacore::_ChannelState> channels_state = {
+        make_channel_state(1, 1), make_channel_state(0, 4),
+        make_channel_state(0, 2), make_channel_state(2, 3)
+    };
+    // lowest priority first, oldest one among equal priorities
+    REQUIRE(kaacore::_select_voice_to_steal(channels_state, 0) == 2);
+    REQUIRE(kaacore::_select_voice_to_steal(channels_state, 2) == 2);
+    channels_state[2].start_order = 5;
+    REQUIRE(kaacore::_select_voice_to_steal(channels_state, 0) == 1);
+
+    // free channels are not stolen
+    channels_state[1].reset();
+    channels_state[2].reset();
+    REQUIRE(kaacore::_select_voice_to_steal(channels_state, 1) == 0);
+    // all voices have higher priority, sound is dropped
+    REQUIRE(kaacore::_select_voice_to_steal(channels_state, 0) == -1);
+    REQUIRE(kaacore::_select_voice_to_steal({}, 0) == -1);
+}
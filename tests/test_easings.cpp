@@ -0,0 +1,83 @@
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "kaacore/easings.h"
+
+constexpr size_t easing_test_samples = 1001;
+
+std::vector<double>
+make_easing_progress_samples(const size_t count)
+{
+    std::vector<double> samples(count);
+    for (size_t i = 0; i < count; i++) {
+        samples[i] = double(i) / (count - 1);
+    }
+    return samples;
+}
+
+TEST_CASE("Test batched easings match scalar easings", "[easings][no_engine]")
+{
+    const auto progress = make_easing_progress_samples(easing_test_samples);
+    std::vector<double> output(progress.size());
+
+    for (int i = int(kaacore::Easing::none);
+         i <= int(kaacore::Easing::sine_out); i++) {
+        const auto easing = static_cast<kaacore::Easing>(i);
+        kaacore::ease_batch(
+            easing, progress.data(), output.data(), progress.size()
+        );
+        for (size_t j = 0; j < progress.size(); j++) {
+            INFO("easing: " << i << ", progress: " << progress[j]);
+            REQUIRE(
+                output[j] ==
+                Approx(kaacore::ease(easing, progress[j])).margin(1e-12)
+            );
+        }
+    }
+
+    SECTION("In-place evaluation")
+    {
+        auto values = progress;
+        kaacore::ease_batch(
+            kaacore::Easing::bounce_in_out, values.data(), values.data(),
+            values.size()
+        );
+        for (size_t j = 0; j < progress.size(); j++) {
+            REQUIRE(
+                values[j] ==
+                Approx(kaacore::ease(kaacore::Easing::bounce_in_out, progress[j]
+                       ))
+                    .margin(1e-12)
+            );
+        }
+    }
+}
+
+TEST_CASE("Benchmark batched easings", "[easings][no_engine][.benchmark]")
+{
+    const auto progress = make_easing_progress_samples(20000);
+    std::vector<double> output(progress.size());
+
+    for (const auto easing :
+         {kaacore::Easing::quadratic_in_out, kaacore::Easing::bounce_out,
+          kaacore::Easing::sine_in_out, kaacore::Easing::elastic_out}) {
+        const auto easing_name = std::to_string(int(easing));
+        BENCHMARK("scalar ease " + easing_name + ", 20000 values")
+        {
+            for (size_t i = 0; i < progress.size(); i++) {
+                output[i] = kaacore::ease(easing, progress[i]);
+            }
+            return output.back();
+        };
+
+        BENCHMARK("ease_batch " + easing_name + ", 20000 values")
+        {
+            kaacore::ease_batch(
+                easing, progress.data(), output.data(), progress.size()
+            );
+            return output.back();
+        };
+    }
+}
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "kaacore/archives.h"
+#include "kaacore/compression.h"
+#include "kaacore/exceptions.h"
+#include "kaacore/files.h"
+#include "kaacore/memory.h"
+
+TEST_CASE("test_map_file", "[files][no_engine]")
+{
+    const std::string path = "test_map_file.bin";
+    std::vector<std::byte> content(100000);
+    for (size_t i = 0; i < content.size(); i++) {
+        content[i] = std::byte(i * 7);
+    }
+    REQUIRE(kaacore::write_file(path, content.data(), content.size()));
+
+    kaacore::Memory memory_copy;
+    {
+        auto memory = kaacore::map_file(path);
+        REQUIRE(memory.size() == content.size());
+        memory_copy = memory;
+    }
+    // mapping is kept alive by remaining copy
+    REQUIRE(memory_copy.size() == content.size());
+    REQUIRE(
+        std::memcmp(memory_copy.get(), content.data(), content.size()) == 0
+    );
+    REQUIRE(kaacore::File{path}.content.size() == content.size());
+
+    memory_copy.destroy();
+    std::remove(path.c_str());
+    REQUIRE_THROWS_AS(kaacore::map_file(path), std::ios_base::failure);
+}
+
+TEST_CASE("Benchmark file reading", "[files][no_engine][.benchmark]")
+{
+    const std::string path = "test_file_benchmark.bin";
+    const std::vector<std::byte> content(16 * 1024 * 1024, std::byte(1));
+    REQUIRE(kaacore::write_file(path, content.data(), content.size()));
+
+    BENCHMARK("read 16MB file")
+    {
+        kaacore::File file{path};
+        return file.content[file.content.size() / 2];
+    };
+    BENCHMARK("map 16MB file")
+    {
+        auto memory = kaacore::map_file(path);
+        return memory.get()[memory.size() / 2];
+    };
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("test_lz4_compression", "[files][no_engine]")
+{
+    std::vector<std::byte> data(50000);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = std::byte((i / 13) % 7 + (i % 3 == 0 ? i * 31 : 0));
+    }
+    for (const size_t size : {size_t(0), size_t(5), size_t(13), data.size()}) {
+        const auto compressed = kaacore::lz4_compress(data.data(), size);
+        REQUIRE(compressed.size() <= kaacore::lz4_compress_bound(size));
+        std::vector<std::byte> decompressed(size);
+        REQUIRE(kaacore::lz4_decompress(
+            compressed.data(), compressed.size(), decompressed.data(), size
+        ));
+        REQUIRE(std::equal(
+            decompressed.begin(), decompressed.end(), data.begin()
+        ));
+    }
+
+    const auto compressed = kaacore::lz4_compress(data.data(), data.size());
+    REQUIRE(compressed.size() < data.size());
+    std::vector<std::byte> decompressed(data.size());
+    REQUIRE_FALSE(kaacore::lz4_decompress(
+        compressed.data(), compressed.size() - 1, decompressed.data(),
+        decompressed.size()
+    ));
+    REQUIRE_FALSE(kaacore::lz4_decompress(
+        compressed.data(), compressed.size(), decompressed.data(),
+        decompressed.size() - 1
+    ));
+}
+
+TEST_CASE("test_archive", "[files][no_engine]")
+{
+    const std::string archive_path = "test_archive.kpak";
+    std::ofstream{"test_archive_a.txt"} << std::string(1000, 'a');
+    std::ofstream{"test_archive_b.txt"} << "b";
+    const std::vector<kaacore::ArchiveInput> inputs{
+        {"images/a.txt", "test_archive_a.txt"},
+        {"./b.txt", "test_archive_b.txt"},
+    };
+
+    for (const bool compress : {false, true}) {
+        REQUIRE(kaacore::write_archive(archive_path, inputs, compress));
+        kaacore::Archive archive{archive_path};
+        REQUIRE(archive.files_count() == 2);
+        REQUIRE(archive.contains("b.txt"));
+        REQUIRE_FALSE(archive.contains("a.txt"));
+        REQUIRE_FALSE(archive.read("missing.txt"));
+
+        auto memory = archive.read("images/a.txt");
+        REQUIRE(memory);
+        REQUIRE(memory->size() == 1000);
+        REQUIRE(
+            std::string(reinterpret_cast<const char*>(memory->get()), 1000) ==
+            std::string(1000, 'a')
+        );
+        REQUIRE(
+            reinterpret_cast<uintptr_t>(archive.read("b.txt")->get()) %
+                kaacore::archive_alignment ==
+            0
+        );
+    }
+
+    kaacore::mount_archive(archive_path, "assets");
+    REQUIRE(kaacore::read_mounted_file("assets/images/a.txt"));
+    REQUIRE(kaacore::map_file("./assets/b.txt").size() == 1);
+    REQUIRE(kaacore::File{"assets/images/a.txt"}.content.size() == 1000);
+    REQUIRE_FALSE(kaacore::read_mounted_file("images/a.txt"));
+    kaacore::unmount_archive(archive_path);
+    REQUIRE_FALSE(kaacore::read_mounted_file("assets/b.txt"));
+    REQUIRE_THROWS_AS(
+        kaacore::map_file("assets/b.txt"), std::ios_base::failure
+    );
+
+    REQUIRE_THROWS_AS(
+        kaacore::write_archive(
+            archive_path,
+            {{"a.txt", "test_archive_a.txt"},
+             {"./a.txt", "test_archive_b.txt"}},
+            false
+        ),
+        kaacore::exception
+    );
+    std::remove("test_archive_a.txt");
+    REQUIRE_THROWS_AS(
+        kaacore::Archive{"test_archive_b.txt"}, kaacore::exception
+    );
+    std::remove("test_archive_b.txt");
+    std::remove(archive_path.c_str());
+}
+
+TEST_CASE("Benchmark archive reading", "[files][no_engine][.benchmark]")
+{
+    const std::string archive_path = "test_archive_benchmark.kpak";
+    std::vector<kaacore::ArchiveInput> inputs;
+    for (size_t i = 0; i < 1000; i++) {
+        const auto path = "test_archive_benchmark_" + std::to_string(i);
+        std::ofstream{path} << std::string(4096, char('a' + i % 26));
+        inputs.push_back({"assets/" + std::to_string(i), path});
+    }
+    REQUIRE(kaacore::write_archive(archive_path, inputs, true));
+
+    BENCHMARK("read 1000 files")
+    {
+        size_t total_size = 0;
+        for (const auto& input : inputs) {
+            total_size += kaacore::map_file(input.source_path).size();
+        }
+        return total_size;
+    };
+    kaacore::mount_archive(archive_path);
+    BENCHMARK("read 1000 files from archive")
+    {
+        size_t total_size = 0;
+        for (const auto& input : inputs) {
+            total_size += kaacore::map_file(input.name).size();
+        }
+        return total_size;
+    };
+    kaacore::unmount_archive(archive_path);
+
+    for (const auto& input : inputs) {
+        std::remove(input.source_path.c_str());
+    }
+    std::remove(archive_path.c_str());
+}
@@ -1,5 +1,13 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
+#include "kaacore/embedded_data.h"
+#include "kaacore/files.h"
+#include "kaacore/font_cache.h"
 #include "kaacore/fonts.h"
 #include "kaacore/nodes.h"
 #include "kaacore/shapes.h"
@@ -43,3 +51,290 @@ TEST_CASE("test_update_empty_text", "[fonts]")
 
     scene.run_on_engine(2);
 }
+
+TEST_CASE("test_decode_utf8", "[fonts][no_engine]")
+{
+    using Codepoints = std::vector<kaacore::UnicodeCodepoint>;
+    const auto replacement = kaacore::unicode_replacement_character;
+
+    REQUIRE(kaacore::decode_utf8("").empty());
+    REQUIRE(kaacore::decode_utf8("ab\n") == Codepoints{'a', 'b', '\n'});
+    REQUIRE(
+        kaacore::decode_utf8("\xC5\xBC\xE2\x82\xAC\xF0\x9F\x98\x80") ==
+        Codepoints{0x17C, 0x20AC, 0x1F600}
+    );
+    // stray continuation byte, overlong encoding, truncated sequence
+    REQUIRE(
+        kaacore::decode_utf8("a\x80b\xC0\xAF\xE2\x82") ==
+        Codepoints{'a', replacement, 'b', replacement, replacement, replacement}
+    );
+}
+
+TEST_CASE("test_dynamic_glyphs_baking", "[fonts]")
+{
+    auto engine = initialize_testing_engine();
+
+    auto memory = kaacore::get_embedded_file_content(
+        kaacore::embedded_assets_filesystem,
+        "embedded_resources/font_munro/munro.ttf"
+    );
+    auto font_data = kaacore::FontData::load_from_memory(memory);
+    const auto initial_dimensions = font_data->baked_texture->get_dimensions();
+
+    auto glyphs = font_data->generate_render_glyphs("a?", 1.);
+    REQUIRE(font_data->dynamic_glyphs_count() == 0);
+    REQUIRE(font_data->baked_texture->get_dimensions() == initial_dimensions);
+    const glm::dvec2 ascii_glyph_position =
+        glyphs[0].texture_uv0 * glm::dvec2(initial_dimensions);
+
+    // euro sign is available in font, ogonek is not
+    glyphs = font_data->generate_render_glyphs("\xE2\x82\xAC\xC4\x85?", 1.);
+    REQUIRE(glyphs.size() == 3);
+    REQUIRE(glyphs[0].codepoint == 0x20AC);
+    REQUIRE(glyphs[1].codepoint == 0x105);
+    REQUIRE(glyphs[0].has_size());
+    REQUIRE(glyphs[1].texture_uv0 == glyphs[2].texture_uv0);
+    REQUIRE(font_data->dynamic_glyphs_count() == 1);
+    REQUIRE(
+        font_data->baked_texture->get_dimensions() ==
+        glm::uvec2{
+            kaacore::font_atlas_page_size, kaacore::font_atlas_page_size
+        }
+    );
+
+    // glyphs baked at load time keep their position in atlas
+    glyphs = font_data->generate_render_glyphs("a", 1.);
+    const glm::dvec2 atlas_glyph_position =
+        glyphs[0].texture_uv0 *
+        glm::dvec2(font_data->baked_texture->get_dimensions());
+    REQUIRE(atlas_glyph_position.x == Approx(ascii_glyph_position.x));
+    REQUIRE(atlas_glyph_position.y == Approx(ascii_glyph_position.y));
+    font_data->generate_render_glyphs("\xE2\x82\xAC", 1.);
+    REQUIRE(font_data->dynamic_glyphs_count() == 1);
+}
+
+TEST_CASE("test_font_cache", "[fonts]")
+{
+    auto engine = initialize_testing_engine();
+
+    auto memory = kaacore::get_embedded_file_content(
+        kaacore::embedded_assets_filesystem,
+        "embedded_resources/font_munro/munro.ttf"
+    );
+    const std::string cache_directory = ".";
+    const auto key =
+        kaacore::calculate_font_cache_key(memory.get(), memory.size());
+    REQUIRE(
+        key !=
+        kaacore::calculate_font_cache_key(memory.get(), memory.size() - 1)
+    );
+    const auto cache_path = kaacore::get_font_cache_path(cache_directory, key);
+    std::remove(cache_path.c_str());
+    REQUIRE_FALSE(kaacore::load_font_cache(cache_directory, key));
+
+    const auto previous_cache_directory = kaacore::get_font_cache_directory();
+    kaacore::set_font_cache_directory(cache_directory);
+    auto baked_font_data = kaacore::FontData::load_from_memory(memory);
+    auto cached_atlas = kaacore::load_font_cache(cache_directory, key);
+    auto cached_font_data = kaacore::FontData::load_from_memory(memory);
+    kaacore::set_font_cache_directory(previous_cache_directory);
+    REQUIRE(cached_atlas);
+    auto cached_texture = kaacore::MemoryTexture::create(
+        std::get<bimg::ImageContainer*>(*cached_atlas)
+    );
+
+    auto baked_texture = dynamic_cast<kaacore::MemoryTexture*>(
+        baked_font_data->baked_texture.get()
+    );
+    REQUIRE(baked_texture);
+    REQUIRE(
+        cached_texture->get_dimensions() == baked_texture->get_dimensions()
+    );
+    REQUIRE(
+        std::memcmp(
+            cached_texture->image_container->m_data,
+            baked_texture->image_container->m_data,
+            baked_texture->image_container->m_size
+        ) == 0
+    );
+
+    REQUIRE(
+        cached_font_data->baked_font.size() ==
+        baked_font_data->baked_font.size()
+    );
+    for (size_t i = 0; i < baked_font_data->baked_font.size(); i++) {
+        const auto& cached = cached_font_data->baked_font[i];
+        const auto& baked = baked_font_data->baked_font[i];
+        REQUIRE(cached.x0 == baked.x0);
+        REQUIRE(cached.y1 == baked.y1);
+        REQUIRE(cached.xoff == baked.xoff);
+        REQUIRE(cached.xadvance == baked.xadvance);
+    }
+    REQUIRE(
+        cached_font_data->font_metrics.height() ==
+        baked_font_data->font_metrics.height()
+    );
+
+    // corrupted cache file is ignored
+    const std::byte garbage[16] = {};
+    REQUIRE(kaacore::write_file(cache_path, garbage, sizeof(garbage)));
+    REQUIRE_FALSE(kaacore::load_font_cache(cache_directory, key));
+    std::remove(cache_path.c_str());
+}
+
+const std::string roboto_font_path =
+    KAACORE_TEST_ASSETS_DIR "/fonts/Roboto/Roboto-Regular.ttf";
+
+std::vector<kaacore::UnicodeCodepoint>
+collect_font_codepoints(const stbtt_fontinfo& font_info, const size_t count)
+{
+    std::vector<kaacore::UnicodeCodepoint> available_codepoints;
+    for (kaacore::UnicodeCodepoint codepoint = 32; codepoint < 0x10000;
+         codepoint++) {
+        if (stbtt_FindGlyphIndex(&font_info, codepoint) != 0) {
+            available_codepoints.push_back(codepoint);
+        }
+    }
+    // repeat glyphs if font doesn't have enough of them
+    std::vector<kaacore::UnicodeCodepoint> codepoints;
+    for (size_t i = 0; i < count; i++) {
+        codepoints.push_back(
+            available_codepoints[i % available_codepoints.size()]
+        );
+    }
+    return codepoints;
+}
+
+TEST_CASE("test_parallel_font_baking", "[fonts][no_engine]")
+{
+    kaacore::File file{roboto_font_path};
+    stbtt_fontinfo font_info;
+    REQUIRE(stbtt_InitFont(&font_info, file.content.data(), 0));
+    const double scale = stbtt_ScaleForPixelHeight(
+        &font_info, kaacore::font_baker_pixel_height
+    );
+    const auto codepoints = collect_font_codepoints(font_info, 300);
+
+    auto [first_image, first_glyphs, first_metrics] =
+        kaacore::bake_font_texture(font_info, scale, codepoints);
+    auto [second_image, second_glyphs, second_metrics] =
+        kaacore::bake_font_texture(font_info, scale, codepoints);
+
+    REQUIRE(first_glyphs.size() == codepoints.size());
+    REQUIRE(
+        std::memcmp(
+            first_glyphs.data(), second_glyphs.data(),
+            first_glyphs.size() * sizeof(stbtt_packedchar)
+        ) == 0
+    );
+    REQUIRE(first_image->m_size == second_image->m_size);
+    REQUIRE(
+        std::memcmp(
+            first_image->m_data, second_image->m_data, first_image->m_size
+        ) == 0
+    );
+    bimg::imageFree(first_image);
+    bimg::imageFree(second_image);
+}
+
+TEST_CASE("Benchmark font baking", "[fonts][no_engine][.benchmark]")
+{
+    kaacore::File file{roboto_font_path};
+    stbtt_fontinfo font_info;
+    REQUIRE(stbtt_InitFont(&font_info, file.content.data(), 0));
+    const double scale = stbtt_ScaleForPixelHeight(
+        &font_info, kaacore::font_baker_pixel_height
+    );
+    const auto codepoints = collect_font_codepoints(font_info, 2048);
+
+    BENCHMARK("bake 2048 glyphs")
+    {
+        auto atlas = kaacore::bake_font_texture(font_info, scale, codepoints);
+        bimg::imageFree(std::get<bimg::ImageContainer*>(atlas));
+    };
+}
+
+TEST_CASE("test_incremental_text_update", "[fonts]")
+{
+    auto engine = initialize_testing_engine();
+
+    auto text_node = kaacore::make_node(kaacore::NodeType::text);
+    text_node->text.line_width(200.);
+    auto font_data = kaacore::get_default_font().font_data();
+
+    const std::vector<std::string> contents = {
+        "Score: 100", "Score: 105",  "Score: 1050 points",
+        "Score: 9",   " lead space", "Score: \xE2\x82\xAC 1",
+        "x",          ""
+    };
+    for (const auto& content : contents) {
+        text_node->text.content(content);
+
+        // layout generated from scratch
+        const double font_size = text_node->text.font_size();
+        auto render_glyphs = font_data->generate_render_glyphs(
+            content, font_size / kaacore::font_baker_pixel_height
+        );
+        kaacore::FontRenderGlyph::arrange_glyphs(
+            render_glyphs, 0., font_size, 200.
+        );
+        const auto reference_shape = kaacore::FontRenderGlyph::make_shape(
+            render_glyphs,
+            font_data->metrics().scale_for_pixel_height(font_size)
+        );
+
+        const auto shape = text_node->shape();
+        REQUIRE(shape.type == reference_shape.type);
+        REQUIRE(shape.vertices == reference_shape.vertices);
+        REQUIRE(shape.indices == reference_shape.indices);
+        REQUIRE(shape.bounding_box() == reference_shape.bounding_box());
+        REQUIRE(shape.bounding_points == reference_shape.bounding_points);
+    }
+}
+
+TEST_CASE("test_text_layout_cache", "[fonts]")
+{
+    auto engine = initialize_testing_engine();
+
+    auto font_data = kaacore::get_default_font().font_data();
+    auto first_node = kaacore::make_node(kaacore::NodeType::text);
+    auto second_node = kaacore::make_node(kaacore::NodeType::text);
+    first_node->text.content("-15 damage");
+    const auto stats = font_data->text_layout_cache_stats();
+    second_node->text.content("-15 damage");
+
+    REQUIRE(font_data->text_layout_cache_stats().hits == stats.hits + 1);
+    REQUIRE(font_data->text_layout_cache_stats().misses == stats.misses);
+    REQUIRE(first_node->shape().vertices == second_node->shape().vertices);
+
+    // same text with different layout parameters is cached separately
+    second_node->text.font_size(40.);
+    REQUIRE(
+        font_data->text_layout_cache_stats().misses == stats.misses + 1
+    );
+    REQUIRE(first_node->shape().vertices != second_node->shape().vertices);
+
+    for (size_t i = 0; i < kaacore::text_layout_cache_capacity * 2; i++) {
+        second_node->text.content(std::to_string(i));
+    }
+    REQUIRE(
+        font_data->text_layout_cache_stats().size ==
+        kaacore::text_layout_cache_capacity
+    );
+}
+
+TEST_CASE("Benchmark text updates", "[fonts][.benchmark]")
+{
+    auto engine = initialize_testing_engine();
+
+    auto text_node = kaacore::make_node(kaacore::NodeType::text);
+    size_t score = 0;
+    BENCHMARK("update HUD text")
+    {
+        text_node->text.content("Score: " + std::to_string(score++));
+    };
+    BENCHMARK("set unchanged text")
+    {
+        text_node->text.content("Score: 0");
+    };
+}
@@ -132,4 +132,36 @@ TEST_CASE("Test hitboxes", "[hitboxes][nodes]")
         transformation_approx_equal(expected_hitbox_transformation, result);
         transformation_approx_equal(expected_hitbox2_transformation, result2);
     }
+
+    SECTION("Hitbox chain transformations update physics shape")
+    {
+        TestingScene scene;
+        auto owned_node = kaacore::make_node();
+        auto owned_body = kaacore::make_node(kaacore::NodeType::body);
+        auto owned_space = kaacore::make_node(kaacore::NodeType::space);
+        auto owned_hitbox = kaacore::make_node(kaacore::NodeType::hitbox);
+        owned_hitbox->shape(kaacore::Shape::Circle(1., glm::dvec2(5., 0.)));
+
+        auto space = scene.root_node.add_child(owned_space);
+        auto body = space->add_child(owned_body);
+        auto node = body->add_child(owned_node);
+        auto hitbox = node->add_child(owned_hitbox);
+
+        auto query_hitbox = [&space](const glm::dvec2 point) {
+            auto results = space->space.query_point_neighbors(point, 0.1);
+            return results.size() == 1 ? results[0].hitbox_node
+                                       : kaacore::NodePtr{};
+        };
+
+        // translation and rotation are applied to existing cpShape
+        node->position(glm::dvec2(10., 0.));
+        REQUIRE(query_hitbox({15., 0.}) == hitbox.get());
+        node->rotation(M_PI / 2);
+        REQUIRE(not query_hitbox({15., 0.}));
+        REQUIRE(query_hitbox({10., 5.}) == hitbox.get());
+
+        // scale requires rebuilding cpShape
+        body->scale(glm::dvec2(2.));
+        REQUIRE(query_hitbox({20., 10.}) == hitbox.get());
+    }
 }
@@ -0,0 +1,165 @@
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "kaacore/engine.h"
+#include "kaacore/exceptions.h"
+#include "kaacore/node_transitions.h"
+#include "kaacore/nodes.h"
+#include "kaacore/physics.h"
+#include "kaacore/snapshots.h"
+
+#include "runner.h"
+
+using namespace std::chrono_literals;
+
+constexpr auto snapshot_test_frame_step = 16666us;
+
+kaacore::NodePtr
+make_populated_space(kaacore::Node& parent, const size_t bodies_count)
+{
+    kaacore::NodeOwnerPtr tmp_space =
+        kaacore::make_node(kaacore::NodeType::space);
+    auto space = parent.add_child(tmp_space);
+    space->space.gravity({0., 10.});
+
+    for (size_t i = 0; i < bodies_count; i++) {
+        kaacore::NodeOwnerPtr tmp_body =
+            kaacore::make_node(kaacore::NodeType::body);
+        auto body = space->add_child(tmp_body);
+        body->position({i * 3., 0.});
+        body->body.velocity({1., -2.});
+        body->body.angular_velocity(0.5);
+
+        kaacore::NodeOwnerPtr tmp_hitbox =
+            kaacore::make_node(kaacore::NodeType::hitbox);
+        tmp_hitbox->shape(kaacore::Shape::Circle(1.));
+        body->add_child(tmp_hitbox);
+    }
+
+    kaacore::NodeOwnerPtr tmp_marker = kaacore::make_node();
+    auto marker = space->add_child(tmp_marker);
+    marker->transition(
+        kaacore::make_node_transition<kaacore::NodePositionTransition>(
+            glm::dvec2{100., 0.}, kaacore::AttributeTransitionMethod::set, 1.s
+        )
+    );
+    return space;
+}
+
+std::vector<glm::dvec2>
+collect_positions(kaacore::NodePtr space)
+{
+    std::vector<glm::dvec2> positions;
+    for (auto node : space->children()) {
+        positions.push_back(node->position());
+    }
+    return positions;
+}
+
+TEST_CASE("Test simulation snapshot restore", "[physics][snapshots]")
+{
+    auto engine = initialize_testing_engine();
+
+    TestingScene scene;
+    scene.update_function = [&scene](auto dt) {
+        auto space = make_populated_space(scene.root_node, 10);
+        scene.step_simulation(snapshot_test_frame_step);
+
+        auto positions_before = collect_positions(space);
+        auto snapshot = kaacore::SimulationSnapshot::capture(space);
+        REQUIRE(snapshot);
+
+        for (int i = 0; i < 8; i++) {
+            scene.step_simulation(snapshot_test_frame_step);
+        }
+        auto positions_after = collect_positions(space);
+        REQUIRE(positions_after != positions_before);
+
+        snapshot.restore(space);
+        REQUIRE(collect_positions(space) == positions_before);
+
+        for (int i = 0; i < 8; i++) {
+            scene.step_simulation(snapshot_test_frame_step);
+        }
+        REQUIRE(collect_positions(space) == positions_after);
+
+        auto other_space = make_populated_space(scene.root_node, 5);
+        REQUIRE_THROWS_AS(snapshot.restore(other_space), kaacore::exception);
+    };
+    scene.run_on_engine(1);
+}
+
+TEST_CASE(
+    "Test simulation snapshot restore of finished transition",
+    "[physics][snapshots]"
+)
+{
+    auto engine = initialize_testing_engine();
+
+    TestingScene scene;
+    scene.update_function = [&scene](auto dt) {
+        auto space = make_populated_space(scene.root_node, 2);
+        kaacore::NodeOwnerPtr tmp_node = kaacore::make_node();
+        auto node = space->add_child(tmp_node);
+        node->transition(
+            kaacore::make_node_transition<kaacore::NodePositionTransition>(
+                glm::dvec2{100., 0.}, kaacore::AttributeTransitionMethod::add,
+                0.05s
+            )
+        );
+        scene.step_simulation(snapshot_test_frame_step);
+
+        const auto position_before = node->position();
+        auto snapshot = kaacore::SimulationSnapshot::capture(space);
+        std::vector<glm::dvec2> positions;
+        for (int i = 0; i < 8; i++) {
+            scene.step_simulation(snapshot_test_frame_step);
+            positions.push_back(node->position());
+        }
+        REQUIRE(not node->transition());
+        REQUIRE(node->position() == glm::dvec2{100., 0.});
+
+        // transition continues from its original origin,
+        // not from position it had when restored
+        snapshot.restore(space);
+        REQUIRE(node->position() == position_before);
+        REQUIRE(node->transition());
+        for (int i = 0; i < 8; i++) {
+            scene.step_simulation(snapshot_test_frame_step);
+            REQUIRE(node->position() == positions[i]);
+        }
+        REQUIRE(not node->transition());
+    };
+    scene.run_on_engine(1);
+}
+
+TEST_CASE(
+    "Benchmark simulation snapshots", "[physics][snapshots][.benchmark]"
+)
+{
+    auto engine = initialize_testing_engine();
+
+    TestingScene scene;
+    scene.update_function = [&scene](auto dt) {
+        auto space = make_populated_space(scene.root_node, 1000);
+        scene.step_simulation(snapshot_test_frame_step);
+        auto snapshot = kaacore::SimulationSnapshot::capture(space);
+
+        BENCHMARK("capture 1000 bodies")
+        {
+            return kaacore::SimulationSnapshot::capture(space);
+        };
+
+        BENCHMARK("restore 1000 bodies") { snapshot.restore(space); };
+
+        BENCHMARK("restore and re-simulate 8 frames of 1000 bodies")
+        {
+            snapshot.restore(space);
+            for (int i = 0; i < 8; i++) {
+                scene.step_simulation(snapshot_test_frame_step);
+            }
+        };
+    };
+    scene.run_on_engine(1);
+}
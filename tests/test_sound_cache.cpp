@@ -0,0 +1,81 @@
+#include <memory>
+
+#include <catch2/catch.hpp>
+
+#include "kaacore/sound_cache.h"
+
+std::shared_ptr<Mix_Chunk>
+make_chunk(const uint32_t size)
+{
+    auto chunk = std::make_shared<Mix_Chunk>();
+    chunk->alen = size;
+    return chunk;
+}
+
+TEST_CASE("test_sound_cache_reuse", "[audio]")
+{
+    kaacore::SoundCache cache{100};
+    REQUIRE(cache.get("sound.wav") == nullptr);
+
+    auto chunk = cache.insert("sound.wav", make_chunk(10));
+    REQUIRE(chunk);
+    // used sounds are not counted
+    REQUIRE(cache.usage() == 0);
+    REQUIRE(cache.get("sound.wav") == chunk);
+    // sound decoded in parallel is replaced by cached one
+    REQUIRE(cache.insert("sound.wav", make_chunk(10)) == chunk);
+
+    const auto raw_chunk = chunk.get();
+    chunk.reset();
+    REQUIRE(cache.usage() == 10);
+    REQUIRE(cache.contains("sound.wav"));
+
+    chunk = cache.get("sound.wav");
+    REQUIRE(chunk.get() == raw_chunk);
+    REQUIRE(cache.usage() == 0);
+}
+
+TEST_CASE("test_sound_cache_budget", "[audio]")
+{
+    kaacore::SoundCache cache{25};
+    auto first = cache.insert("first.wav", make_chunk(10));
+    auto second = cache.insert("second.wav", make_chunk(10));
+    auto third = cache.insert("third.wav", make_chunk(10));
+    // used sounds are kept regardless of the budget
+    cache.budget(0);
+    REQUIRE(cache.contains("first.wav"));
+    REQUIRE(cache.usage() == 0);
+    cache.budget(25);
+
+    first.reset();
+    second.reset();
+    REQUIRE(cache.usage() == 20);
+    // first one becomes most recently used
+    cache.get("first.wav");
+    third.reset();
+    REQUIRE(cache.usage() == 20);
+    REQUIRE(cache.contains("first.wav"));
+    REQUIRE_FALSE(cache.contains("second.wav"));
+    REQUIRE(cache.contains("third.wav"));
+
+    cache.budget(10);
+    REQUIRE(cache.usage() == 10);
+    REQUIRE_FALSE(cache.contains("first.wav"));
+    REQUIRE(cache.contains("third.wav"));
+
+    cache.budget(0);
+    REQUIRE(cache.usage() == 0);
+    REQUIRE_FALSE(cache.contains("third.wav"));
+    REQUIRE(cache.get("third.wav") == nullptr);
+}
+
+TEST_CASE("test_sound_cache_outlived", "[audio]")
+{
+    std::shared_ptr<Mix_Chunk> chunk;
+    {
+        kaacore::SoundCache cache;
+        chunk = cache.insert("sound.wav", make_chunk(10));
+    }
+    REQUIRE(chunk->alen == 10);
+    chunk.reset();
+}
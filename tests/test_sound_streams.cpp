@@ -0,0 +1,103 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "kaacore/exceptions.h"
+#include "kaacore/sound_streams.h"
+
+// 16-bit mono PCM WAV file
+void
+write_wav_file(
+    const std::string& path, const int frequency,
+    const std::vector<int16_t>& samples
+)
+{
+    auto write_u16 = [](std::ofstream& file, const uint16_t value) {
+        const char bytes[2] = {char(value & 0xFF), char(value >> 8)};
+        file.write(bytes, 2);
+    };
+    auto write_u32 = [&write_u16](std::ofstream& file, const uint32_t value) {
+        write_u16(file, value & 0xFFFF);
+        write_u16(file, value >> 16);
+    };
+    const uint32_t data_size = samples.size() * 2;
+    std::ofstream file{path, std::ios::binary};
+    file.write("RIFF", 4);
+    write_u32(file, 36 + data_size);
+    file.write("WAVEfmt ", 8);
+    write_u32(file, 16);
+    write_u16(file, 1);
+    write_u16(file, 1);
+    write_u32(file, frequency);
+    write_u32(file, frequency * 2);
+    write_u16(file, 2);
+    write_u16(file, 16);
+    file.write("data", 4);
+    write_u32(file, data_size);
+    for (const auto sample : samples) {
+        write_u16(file, uint16_t(sample));
+    }
+}
+
+std::vector<int16_t>
+decode_samples(kaacore::WavStreamDecoder& decoder, const size_t max_samples)
+{
+    std::vector<int16_t> samples;
+    int16_t chunk[7];
+    size_t decoded_size;
+    while (samples.size() < max_samples and
+           (decoded_size = decoder.decode(
+                reinterpret_cast<std::byte*>(chunk), sizeof(chunk)
+            )) > 0) {
+        samples.insert(samples.end(), chunk, chunk + decoded_size / 2);
+    }
+    return samples;
+}
+
+TEST_CASE("test_wav_stream_decoder", "[audio][no_engine]")
+{
+    const std::string path = "test_stream.wav";
+    const std::vector<int16_t> samples{0, 1000, -1000, 32767, -32768, 5, 6, 7};
+    write_wav_file(path, 22050, samples);
+
+    SECTION("Looped playback")
+    {
+        kaacore::WavStreamDecoder decoder{path, AUDIO_S16LSB, 1, 22050, 2};
+        REQUIRE(decoder.frame_size() == 2);
+        auto expected_samples = samples;
+        expected_samples.insert(
+            expected_samples.end(), samples.begin(), samples.end()
+        );
+        REQUIRE(decode_samples(decoder, 100) == expected_samples);
+    }
+
+    SECTION("Infinite loop")
+    {
+        kaacore::WavStreamDecoder decoder{path, AUDIO_S16LSB, 1, 22050, 0};
+        REQUIRE(decode_samples(decoder, 100).size() >= 100);
+    }
+
+    SECTION("Channels conversion")
+    {
+        kaacore::WavStreamDecoder decoder{path, AUDIO_S16LSB, 2, 22050};
+        REQUIRE(decoder.frame_size() == 4);
+        const auto decoded_samples = decode_samples(decoder, 100);
+        REQUIRE(decoded_samples.size() == 2 * samples.size());
+        REQUIRE(decoded_samples[2] == decoded_samples[3]);
+    }
+
+    SECTION("Invalid file")
+    {
+        std::ofstream{path, std::ios::binary} << "not a wav file";
+        REQUIRE_THROWS_AS(
+            kaacore::WavStreamDecoder(path, AUDIO_S16LSB, 1, 22050),
+            kaacore::exception
+        );
+    }
+
+    std::remove(path.c_str());
+}
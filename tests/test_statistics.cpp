@@ -1,4 +1,5 @@
 #include <cmath>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -46,6 +47,174 @@ TEST_CASE(
     REQUIRE(stats.min_value == -10.);
 }
 
+TEST_CASE("Test statistic histogram", "[statistics][no_engine]")
+{
+    SECTION("Uniform distribution")
+    {
+        StatisticHistogram histogram{1.};
+        for (auto i = 1; i <= 10000; i++) {
+            histogram.record(i);
+        }
+        REQUIRE(histogram.count() == 10000);
+        REQUIRE(histogram.percentile(0.) == 1.);
+        REQUIRE(histogram.percentile(50.) == Approx(5000.).epsilon(0.01));
+        REQUIRE(histogram.percentile(95.) == Approx(9500.).epsilon(0.01));
+        REQUIRE(histogram.percentile(99.) == Approx(9900.).epsilon(0.01));
+        REQUIRE(histogram.percentile(99.9) == Approx(9990.).epsilon(0.01));
+        REQUIRE(histogram.percentile(100.) == 10000.);
+    }
+
+    SECTION("Small values are exact")
+    {
+        StatisticHistogram histogram{1.};
+        for (auto i = 0; i < 100; i++) {
+            histogram.record(i % 10);
+        }
+        REQUIRE(histogram.percentile(50.) == 4.);
+        REQUIRE(histogram.percentile(95.) == 9.);
+    }
+
+    SECTION("Frame hitches")
+    {
+        StatisticHistogram histogram;
+        for (auto i = 0; i < 990; i++) {
+            histogram.record(0.0166);
+        }
+        for (auto i = 0; i < 10; i++) {
+            histogram.record(0.1);
+        }
+        REQUIRE(histogram.percentile(50.) == Approx(0.0166).epsilon(0.01));
+        REQUIRE(histogram.percentile(99.) == Approx(0.0166).epsilon(0.01));
+        REQUIRE(histogram.percentile(99.9) == Approx(0.1).epsilon(0.01));
+    }
+
+    SECTION("Merging and reset")
+    {
+        StatisticHistogram histogram{1.};
+        StatisticHistogram other_histogram{1.};
+        histogram.record(-5.);
+        other_histogram.record(1000000.);
+        histogram.merge(other_histogram);
+        REQUIRE(histogram.count() == 2);
+        REQUIRE(histogram.min_value() == -5.);
+        REQUIRE(histogram.percentile(100.) == 1000000.);
+        histogram.reset();
+        REQUIRE(histogram.count() == 0);
+        REQUIRE(std::isnan(histogram.percentile(50.)));
+    }
+}
+
+TEST_CASE("Test statistics windows", "[statistics][no_engine]")
+{
+    StatisticWindowOptions window_options;
+    window_options.length = 100;
+    window_options.resolution = 1.;
+
+    SECTION("Sliding window")
+    {
+        FrameStatisticTracker stat_tracker{window_options};
+        REQUIRE(std::isnan(stat_tracker.analyse().percentile_50));
+        for (auto i = 0; i < 1000; i++) {
+            stat_tracker.push_value(1.);
+        }
+        for (auto i = 0; i < 100; i++) {
+            stat_tracker.push_value(2.);
+        }
+        auto stats = stat_tracker.analyse();
+        REQUIRE(stats.window_samples_count == 100);
+        REQUIRE(stats.percentile_50 == 2.);
+        stat_tracker.push_value(3.);
+        stats = stat_tracker.analyse();
+        REQUIRE(stats.window_samples_count == 76);
+        REQUIRE(stats.percentile_99 == 3.);
+    }
+
+    SECTION("Tumbling window")
+    {
+        window_options.reset = StatisticWindowReset::tumbling;
+        FrameStatisticTracker stat_tracker{window_options};
+        for (auto i = 0; i < 50; i++) {
+            stat_tracker.push_value(1.);
+        }
+        REQUIRE(stat_tracker.analyse().window_samples_count == 50);
+        for (auto i = 0; i < 100; i++) {
+            stat_tracker.push_value(2.);
+        }
+        // last full window is reported
+        auto stats = stat_tracker.analyse();
+        REQUIRE(stats.window_samples_count == 100);
+        REQUIRE(stats.percentile_50 == 1.);
+        REQUIRE(stats.percentile_99_9 == 2.);
+    }
+
+    SECTION("Cumulative window")
+    {
+        window_options.reset = StatisticWindowReset::cumulative;
+        StatisticsManager stats_manager;
+        const auto stat =
+            stats_manager.register_stat("cumulative:time", window_options);
+        for (auto i = 0; i < 1000; i++) {
+            stats_manager.push_value(stat, i);
+        }
+        auto analysis = stats_manager.get_analysis_all();
+        REQUIRE(analysis[0].second.window_samples_count == 1000);
+        stats_manager.reset_window(stat);
+        analysis = stats_manager.get_analysis_all();
+        REQUIRE(analysis[0].second.window_samples_count == 0);
+        REQUIRE(analysis[0].second.samples_count == 50);
+    }
+}
+
+TEST_CASE("Test statistics handles", "[statistics][no_engine]")
+{
+    StatisticsManager stats_manager;
+    const auto stat = stats_manager.register_stat("test:count");
+    REQUIRE(stats_manager.register_stat("test:count") == stat);
+    REQUIRE(stats_manager.register_stat("other:count") != stat);
+
+    SECTION("Values are merged on read")
+    {
+        stats_manager.push_value(stat, 1.);
+        stats_manager.push_value("test:count", 2.);
+        const auto last_values = stats_manager.get_last_all();
+        REQUIRE(last_values.size() == 2);
+        REQUIRE(last_values[0].first == "test:count");
+        REQUIRE(last_values[0].second == 2.);
+    }
+
+    SECTION("Full buffer is merged")
+    {
+        for (auto i = 0; i < 3 * statistics_thread_buffer_size; i++) {
+            stats_manager.push_value(stat, i);
+        }
+        stats_manager.flush();
+        const auto analysis = stats_manager.get_analysis_all();
+        REQUIRE(analysis[0].second.samples_count == 50);
+        REQUIRE(
+            analysis[0].second.last_value ==
+            3 * statistics_thread_buffer_size - 1
+        );
+    }
+
+    SECTION("Pushing from multiple threads")
+    {
+        std::vector<std::thread> threads;
+        for (auto i = 0; i < 4; i++) {
+            threads.emplace_back([&stats_manager, stat]() {
+                for (auto j = 0; j < statistics_thread_buffer_size; j++) {
+                    stats_manager.push_value(stat, 5.);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const auto analysis = stats_manager.get_analysis_all();
+        REQUIRE(analysis[0].second.samples_count == 50);
+        REQUIRE(analysis[0].second.mean_value == 5.);
+    }
+}
+
 template<typename T>
 T
 _parse_type_bytes(std::byte*& data_ptr)
@@ -1,6 +1,15 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <catch2/catch.hpp>
 #include <glm/gtc/type_precision.hpp>
 
+#include "kaacore/exceptions.h"
 #include "kaacore/textures.h"
 
 #include "runner.h"
@@ -142,3 +151,328 @@ TEST_CASE("Test texture pixel query", "[texture][query]")
         glm::dvec4{40 / 255.f, 41 / 255.f, 42 / 255.f, 255 / 255.f}
     );
 }
+
+TEST_CASE("test_compressed_texture", "[texture]")
+{
+    auto engine = initialize_testing_engine();
+    // single BC1 block, all texels use first (white) endpoint
+    const std::vector<uint8_t> block{0xFF, 0xFF, 0x00, 0x00, 0, 0, 0, 0};
+    auto image_container = kaacore::load_raw_image(
+        bimg::TextureFormat::Enum::BC1, 4, 4, block
+    );
+    REQUIRE_FALSE(kaacore::can_query_image(image_container));
+
+    auto decoded_image = kaacore::convert_image(
+        image_container, bimg::TextureFormat::Enum::RGBA8
+    );
+    REQUIRE(decoded_image->m_width == 4);
+    REQUIRE(decoded_image->m_height == 4);
+    REQUIRE(
+        kaacore::query_image_pixel(decoded_image, {3, 3}) ==
+        glm::dvec4{1., 1., 1., 1.}
+    );
+    bimg::imageFree(decoded_image);
+
+    // unsupported formats are decoded on upload
+    const bool format_supported =
+        kaacore::is_texture_format_supported(bimg::TextureFormat::Enum::BC1);
+    auto texture = kaacore::MemoryTexture::create(image_container);
+    REQUIRE(texture->can_query() == not format_supported);
+    REQUIRE(texture->get_dimensions() == glm::uvec2{4, 4});
+}
+
+TEST_CASE("test_generate_image_mips", "[texture]")
+{
+    auto engine = initialize_testing_engine();
+    // opaque red left half, fully transparent right half
+    const std::vector<uint8_t> image_content{
+        255, 0, 0, 255, 255, 0, 0, 255, 0, 0, 0, 0, 0, 0, 0, 0,
+        255, 0, 0, 255, 255, 0, 0, 255, 0, 0, 0, 0, 0, 0, 0, 0,
+    };
+    auto image_container = kaacore::load_raw_image(
+        bimg::TextureFormat::Enum::RGBA8, 4, 2, image_content
+    );
+    auto texture = kaacore::MemoryTexture::create(
+        image_container, {true, BGFX_SAMPLER_MIN_ANISOTROPIC}
+    );
+    const auto mipped_image = texture->image_container.get();
+    REQUIRE(mipped_image->m_numMips == 3);
+    REQUIRE(texture->get_dimensions() == glm::uvec2{4, 2});
+    REQUIRE(
+        std::memcmp(
+            mipped_image->m_data, image_content.data(), image_content.size()
+        ) == 0
+    );
+
+    bimg::ImageMip mip;
+    bimg::imageGetRawData(
+        *mipped_image, 0, 1, mipped_image->m_data, mipped_image->m_size, mip
+    );
+    REQUIRE(mip.m_width == 2);
+    REQUIRE(mip.m_height == 1);
+    REQUIRE(
+        std::vector<uint8_t>(mip.m_data, mip.m_data + 8) ==
+        std::vector<uint8_t>{255, 0, 0, 255, 0, 0, 0, 0}
+    );
+    // transparent texels don't affect color
+    bimg::imageGetRawData(
+        *mipped_image, 0, 2, mipped_image->m_data, mipped_image->m_size, mip
+    );
+    REQUIRE(
+        std::vector<uint8_t>(mip.m_data, mip.m_data + 4) ==
+        std::vector<uint8_t>{255, 0, 0, 128}
+    );
+}
+
+TEST_CASE("test_image_retention", "[texture]")
+{
+    auto engine = initialize_testing_engine();
+    const size_t initial_bytes =
+        kaacore::get_textures_residency_stats().cpu_image_bytes;
+    // opaque red left half, fully transparent right half
+    std::vector<uint8_t> image_content(4 * 4 * 4, 0);
+    for (size_t i = 0; i < 16; i++) {
+        if (i % 4 < 2) {
+            image_content[i * 4] = 255;
+            image_content[i * 4 + 3] = 255;
+        }
+    }
+    auto create_texture = [&](const kaacore::ImageRetention retention) {
+        return kaacore::MemoryTexture::create(
+            kaacore::load_raw_image(
+                bimg::TextureFormat::Enum::RGBA8, 4, 4, image_content
+            ),
+            {false, BGFX_SAMPLER_NONE, retention}
+        );
+    };
+
+    auto full_texture = create_texture(kaacore::ImageRetention::full);
+    REQUIRE(full_texture->image_container != nullptr);
+    REQUIRE(full_texture->query_pixel({1, 3}) == glm::dvec4{1., 0., 0., 1.});
+    REQUIRE(full_texture->query_pixel({2, 3}) == glm::dvec4{0., 0., 0., 0.});
+
+    auto downsampled_texture =
+        create_texture(kaacore::ImageRetention::downsampled);
+    REQUIRE(downsampled_texture->image_container == nullptr);
+    REQUIRE(downsampled_texture->get_dimensions() == glm::uvec2{4, 4});
+    REQUIRE(
+        downsampled_texture->query_pixel({0, 3}) == glm::dvec4{1., 0., 0., 1.}
+    );
+    REQUIRE(downsampled_texture->query_pixel({3, 0}).a == 0.);
+
+    auto alpha_texture = create_texture(kaacore::ImageRetention::alpha);
+    REQUIRE(alpha_texture->image_container == nullptr);
+    REQUIRE(alpha_texture->can_query());
+    REQUIRE(alpha_texture->query_pixel({1, 2}).a == 1.);
+    REQUIRE(alpha_texture->query_pixel({2, 2}).a == 0.);
+
+    auto released_texture = create_texture(kaacore::ImageRetention::none);
+    REQUIRE(released_texture->image_container == nullptr);
+    REQUIRE_FALSE(released_texture->can_query());
+    REQUIRE_THROWS_AS(
+        released_texture->query_pixel({0, 0}), kaacore::exception
+    );
+
+    // renderer frees released images once their upload is done
+    TestingScene scene;
+    scene.run_on_engine(3);
+    REQUIRE(
+        kaacore::get_textures_residency_stats().cpu_image_bytes ==
+        initial_bytes + 4 * 4 * 4 + 2 * 2 * 4 + 4 * 4
+    );
+}
+
+// uncompressed 32-bit TGA filled with single BGRA color
+void
+write_tga_image(
+    const std::string& path, const uint16_t width, const uint16_t height,
+    const std::vector<uint8_t>& bgra
+)
+{
+    const uint8_t header[18] = {
+        0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, uint8_t(width & 0xFF),
+        uint8_t(width >> 8), uint8_t(height & 0xFF), uint8_t(height >> 8), 32,
+        0x28
+    };
+    std::ofstream file(path, std::ofstream::binary);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (size_t i = 0; i < size_t(width) * height; i++) {
+        file.write(reinterpret_cast<const char*>(bgra.data()), 4);
+    }
+}
+
+TEST_CASE("test_async_texture_loading", "[texture]")
+{
+    auto engine = initialize_testing_engine();
+    const std::string path = "test_async_texture.tga";
+    write_tga_image(path, 4, 2, {30, 20, 10, 255});
+
+    auto texture = kaacore::ImageTexture::load_async(path);
+    REQUIRE(texture.get() == kaacore::ImageTexture::load_async(path).get());
+    // GPU texture is created only on engine thread, between frames
+    REQUIRE_FALSE(texture->is_loaded());
+    REQUIRE_FALSE(texture->can_query());
+    REQUIRE(texture->get_dimensions() == glm::uvec2{1, 1});
+    REQUIRE(
+        texture->handle().idx == engine->renderer->default_texture->handle().idx
+    );
+
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (not texture->is_loaded() and
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        kaacore::process_pending_textures();
+    }
+    REQUIRE(texture->is_loaded());
+    REQUIRE(texture->get_dimensions() == glm::uvec2{4, 2});
+    REQUIRE(
+        texture->handle().idx != engine->renderer->default_texture->handle().idx
+    );
+    REQUIRE(
+        texture->query_pixel({3, 1}) ==
+        glm::dvec4{10 / 255.f, 20 / 255.f, 30 / 255.f, 255 / 255.f}
+    );
+    REQUIRE(texture.get() == kaacore::ImageTexture::load(path).get());
+    std::remove(path.c_str());
+
+    auto missing_texture =
+        kaacore::ImageTexture::load_async("missing_async_texture.tga");
+    REQUIRE_THROWS(missing_texture->wait_until_loaded());
+    REQUIRE_FALSE(missing_texture->is_loaded());
+    REQUIRE(missing_texture->get_dimensions() == glm::uvec2{1, 1});
+    // failure is kept, also when it's first seen between frames
+    REQUIRE_THROWS(missing_texture->wait_until_loaded());
+    REQUIRE_THROWS(kaacore::ImageTexture::load("missing_async_texture.tga"));
+    auto other_missing_texture =
+        kaacore::ImageTexture::load_async("other_missing_texture.tga");
+    for (int i = 0; i < 100; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        kaacore::process_pending_textures();
+    }
+    REQUIRE_THROWS(other_missing_texture->wait_until_loaded());
+    REQUIRE_THROWS(kaacore::ImageTexture::load("other_missing_texture.tga"));
+
+    const std::string corrupted_path = "test_corrupted_texture.png";
+    std::ofstream{corrupted_path, std::ofstream::binary}
+        << "definitely not an image";
+    auto corrupted_texture = kaacore::ImageTexture::load_async(corrupted_path);
+    REQUIRE_THROWS_AS(
+        corrupted_texture->wait_until_loaded(), kaacore::exception
+    );
+    REQUIRE_FALSE(corrupted_texture->is_loaded());
+    std::remove(corrupted_path.c_str());
+}
+
+TEST_CASE("test_textures_residency", "[texture]")
+{
+    auto engine = initialize_testing_engine();
+    const size_t texture_size = 64 * 64 * 4;
+    std::vector<std::string> paths;
+    std::vector<kaacore::ResourceReference<kaacore::ImageTexture>> textures;
+    for (size_t i = 0; i < 3; i++) {
+        paths.push_back("test_residency_" + std::to_string(i) + ".tga");
+        write_tga_image(paths.back(), 64, 64, {0, 0, 0, 255});
+        textures.push_back(kaacore::ImageTexture::load(paths.back()));
+    }
+    const auto default_handle = engine->renderer->default_texture->handle();
+    const auto initial_stats = kaacore::get_textures_residency_stats();
+    REQUIRE(initial_stats.resident_count == 3);
+    REQUIRE(initial_stats.resident_bytes == 3 * texture_size);
+
+    kaacore::set_textures_memory_budget(2 * texture_size);
+    // textures uploaded in current frame are not evicted
+    kaacore::update_textures_residency();
+    REQUIRE(kaacore::get_textures_residency_stats().resident_count == 3);
+
+    textures[1]->bind_handle();
+    textures[2]->bind_handle();
+    kaacore::update_textures_residency();
+    auto stats = kaacore::get_textures_residency_stats();
+    REQUIRE(stats.resident_bytes == 2 * texture_size);
+    REQUIRE(stats.evictions == initial_stats.evictions + 1);
+    REQUIRE_FALSE(textures[0]->is_resident());
+    REQUIRE(textures[0]->handle().idx == default_handle.idx);
+    REQUIRE(textures[0]->get_dimensions() == glm::uvec2{64, 64});
+    // image retained in RAM is not released by eviction
+    REQUIRE(textures[0]->is_loaded());
+    REQUIRE(textures[0]->query_pixel({0, 0}) == glm::dvec4{0., 0., 0., 1.});
+
+    // drawing evicted texture uploads its retained image right away
+    REQUIRE(textures[0]->bind_handle().idx != default_handle.idx);
+    REQUIRE(textures[0]->is_resident());
+    kaacore::update_textures_residency();
+    stats = kaacore::get_textures_residency_stats();
+    REQUIRE(stats.reloads == initial_stats.reloads + 1);
+    REQUIRE(stats.resident_bytes == 2 * texture_size);
+    REQUIRE(textures[0]->is_resident());
+    REQUIRE_FALSE(textures[1]->is_resident());
+    REQUIRE(textures[2]->is_resident());
+
+    // loading evicted texture reloads it synchronously
+    kaacore::set_textures_memory_budget(0);
+    auto reloaded_texture = kaacore::ImageTexture::load(paths[1]);
+    REQUIRE(reloaded_texture.get() == textures[1].get());
+    REQUIRE(reloaded_texture->is_resident());
+    REQUIRE(
+        kaacore::get_textures_residency_stats().reloads ==
+        initial_stats.reloads + 2
+    );
+
+    // image which is not retained is decoded from file again,
+    // placeholder is drawn until then
+    const std::string alpha_path = "test_residency_alpha.tga";
+    write_tga_image(alpha_path, 64, 64, {0, 0, 0, 255});
+    kaacore::TextureOptions alpha_options;
+    alpha_options.image_retention = kaacore::ImageRetention::alpha;
+    auto alpha_texture = kaacore::ImageTexture::load(alpha_path, alpha_options);
+    kaacore::set_textures_memory_budget(1);
+    kaacore::update_textures_residency();
+    kaacore::update_textures_residency();
+    REQUIRE_FALSE(alpha_texture->is_resident());
+    REQUIRE(alpha_texture->query_pixel({0, 0}).a == 1.);
+    REQUIRE(alpha_texture->bind_handle().idx == default_handle.idx);
+    alpha_texture->wait_until_loaded();
+    REQUIRE(alpha_texture->is_resident());
+    REQUIRE(alpha_texture->handle().idx != default_handle.idx);
+    kaacore::set_textures_memory_budget(0);
+    std::remove(alpha_path.c_str());
+
+    for (const auto& path : paths) {
+        std::remove(path.c_str());
+    }
+}
+
+TEST_CASE("Benchmark texture loading", "[texture][.benchmark]")
+{
+    auto engine = initialize_testing_engine();
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < 500; i++) {
+        paths.push_back("test_texture_benchmark_" + std::to_string(i) + ".tga");
+        write_tga_image(paths.back(), 256, 256, {255, 128, 0, 255});
+    }
+
+    BENCHMARK("load 500 textures")
+    {
+        std::vector<kaacore::ResourceReference<kaacore::ImageTexture>> textures;
+        for (const auto& path : paths) {
+            textures.push_back(kaacore::ImageTexture::load(path));
+        }
+        return textures.size();
+    };
+    BENCHMARK("load 500 textures asynchronously")
+    {
+        std::vector<kaacore::ResourceReference<kaacore::ImageTexture>> textures;
+        for (const auto& path : paths) {
+            textures.push_back(kaacore::ImageTexture::load_async(path));
+        }
+        for (auto& texture : textures) {
+            texture->wait_until_loaded();
+        }
+        return textures.size();
+    };
+
+    for (const auto& path : paths) {
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "kaacore/threading.h"
+
+TEST_CASE("test_thread_pool_parallel_for", "[threading][no_engine]")
+{
+    kaacore::ThreadPool pool{3};
+    REQUIRE(pool.threads_count() == 3);
+
+    std::vector<size_t> results(1000, 0);
+    pool.parallel_for(results.size(), [&results](const size_t index) {
+        results[index] += index;
+    });
+    for (size_t i = 0; i < results.size(); i++) {
+        REQUIRE(results[i] == i);
+    }
+
+    std::atomic<int> calls_count = 0;
+    pool.parallel_for(0, [&calls_count](const size_t) { calls_count++; });
+    REQUIRE(calls_count == 0);
+
+    // nested calls from pool's threads must not deadlock
+    pool.parallel_for(8, [&pool, &calls_count](const size_t) {
+        pool.parallel_for(8, [&calls_count](const size_t) { calls_count++; });
+    });
+    REQUIRE(calls_count == 64);
+
+    auto result = pool.submit([]() { return 42; });
+    REQUIRE(result.get() == 42);
+}
+
+TEST_CASE("test_thread_pool_exceptions", "[threading][no_engine]")
+{
+    kaacore::ThreadPool pool{2};
+    REQUIRE_THROWS_AS(
+        pool.parallel_for(
+            100,
+            [](const size_t index) {
+                if (index == 50) {
+                    throw std::runtime_error("failed");
+                }
+            }
+        ),
+        std::runtime_error
+    );
+
+    auto result =
+        pool.submit([]() -> int { throw std::logic_error("failed"); });
+    REQUIRE_THROWS_AS(result.get(), std::logic_error);
+}
+
+TEST_CASE("test_spsc_ring_buffer", "[threading][no_engine]")
+{
+    kaacore::SpscRingBuffer ring_buffer{8};
+    std::vector<std::byte> data(6);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = std::byte(i);
+    }
+    REQUIRE(ring_buffer.write(data.data(), 6) == 6);
+    REQUIRE(ring_buffer.free_space() == 2);
+
+    std::vector<std::byte> output(8);
+    REQUIRE(ring_buffer.read(output.data(), 4) == 4);
+    REQUIRE(output[3] == std::byte(3));
+    // write and read across the end of the buffer
+    REQUIRE(ring_buffer.write(data.data(), 6) == 6);
+    REQUIRE(ring_buffer.write(data.data(), 6) == 0);
+    REQUIRE(ring_buffer.available() == 8);
+    REQUIRE(ring_buffer.read(output.data(), 10) == 8);
+    REQUIRE(
+        output == std::vector<std::byte>{
+                      std::byte(4), std::byte(5), std::byte(0), std::byte(1),
+                      std::byte(2), std::byte(3), std::byte(4), std::byte(5)
+                  }
+    );
+
+    SECTION("Concurrent producer and consumer")
+    {
+        const size_t total_size = 1 << 16;
+        std::thread producer{[&ring_buffer]() {
+            size_t position = 0;
+            std::byte chunk[5];
+            while (position < total_size) {
+                const size_t size = std::min<size_t>(5, total_size - position);
+                for (size_t i = 0; i < size; i++) {
+                    chunk[i] = std::byte(position + i);
+                }
+                size_t written = 0;
+                while (written < size) {
+                    written +=
+                        ring_buffer.write(chunk + written, size - written);
+                    std::this_thread::yield();
+                }
+                position += size;
+            }
+        }};
+        size_t position = 0;
+        bool matches = true;
+        std::byte chunk[3];
+        while (position < total_size) {
+            const size_t size = ring_buffer.read(chunk, 3);
+            for (size_t i = 0; i < size; i++) {
+                matches = matches and chunk[i] == std::byte(position + i);
+            }
+            position += size;
+            std::this_thread::yield();
+        }
+        producer.join();
+        REQUIRE(matches);
+    }
+}
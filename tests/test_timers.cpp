@@ -0,0 +1,130 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "kaacore/timers.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Test timers firing order", "[timers][no_engine]")
+{
+    kaacore::TimersManager manager;
+    std::vector<int> fired;
+
+    kaacore::Timer timer_a{[&fired](auto context) {
+        fired.push_back(1);
+        return 0.s;
+    }};
+    kaacore::Timer timer_b{[&fired](auto context) {
+        fired.push_back(2);
+        return 0.s;
+    }};
+    kaacore::Timer timer_repeating{[&fired](auto context) {
+        fired.push_back(3);
+        return 0.010s;
+    }};
+    manager.start(0.030s, timer_a);
+    manager.start(0.020s, timer_b);
+    manager.start(0.010s, timer_repeating);
+
+    manager.process(10ms);
+    REQUIRE(fired == std::vector<int>{3});
+    manager.process(10ms);
+    REQUIRE(fired == std::vector<int>{3, 2, 3});
+    manager.process(10ms);
+    REQUIRE(fired == std::vector<int>{3, 2, 3, 1, 3});
+    REQUIRE(timer_repeating.is_running());
+    REQUIRE(not timer_a.is_running());
+
+    timer_repeating.stop();
+    manager.process(50ms);
+    REQUIRE(fired == std::vector<int>{3, 2, 3, 1, 3});
+
+    SECTION("Restarted timer fires only once")
+    {
+        manager.start(0.010s, timer_a);
+        manager.start(0.020s, timer_a);
+        manager.process(30ms);
+        REQUIRE(fired == std::vector<int>{3, 2, 3, 1, 3, 1});
+    }
+
+    SECTION("Deleted timer does not fire")
+    {
+        {
+            kaacore::Timer timer_tmp{[&fired](auto context) {
+                fired.push_back(4);
+                return 0.s;
+            }};
+            manager.start(0.010s, timer_tmp);
+        }
+        manager.process(30ms);
+        REQUIRE(fired == std::vector<int>{3, 2, 3, 1, 3});
+    }
+}
+
+TEST_CASE("Test starting timers from multiple threads", "[timers][no_engine]")
+{
+    constexpr size_t producers_count = 4;
+    constexpr size_t timers_per_producer = 2000;
+
+    kaacore::TimersManager manager;
+    std::atomic<size_t> fired_count = 0;
+    std::atomic<size_t> finished_producers = 0;
+    std::vector<kaacore::Timer> timers;
+    timers.reserve(producers_count * timers_per_producer);
+    for (size_t i = 0; i < producers_count * timers_per_producer; i++) {
+        timers.emplace_back([&fired_count](auto context) {
+            fired_count++;
+            return 0.s;
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < producers_count; p++) {
+        producers.emplace_back([&, p]() {
+            for (size_t i = 0; i < timers_per_producer; i++) {
+                manager.start(0.001s, timers[p * timers_per_producer + i]);
+            }
+            finished_producers++;
+        });
+    }
+
+    while (finished_producers.load() < producers_count) {
+        manager.process(1ms);
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    manager.process(1ms);
+    manager.process(1ms);
+
+    REQUIRE(fired_count.load() == producers_count * timers_per_producer);
+    for (const auto& timer : timers) {
+        REQUIRE(not timer.is_running());
+    }
+}
+
+TEST_CASE("Benchmark timers", "[timers][no_engine][.benchmark]")
+{
+    kaacore::TimersManager manager;
+    uint64_t fired_count = 0;
+    std::vector<kaacore::Timer> timers;
+    timers.reserve(100000);
+    for (size_t i = 0; i < 100000; i++) {
+        const auto interval = kaacore::Duration(0.001 * (1 + i % 500));
+        timers.emplace_back([&fired_count, interval](auto context) {
+            fired_count++;
+            return interval;
+        });
+        manager.start(interval, timers.back());
+    }
+    manager.process(16666us);
+
+    BENCHMARK("process frame with 100000 active timers")
+    {
+        manager.process(16666us);
+        return fired_count;
+    };
+}
@@ -0,0 +1,80 @@
+#include <string>
+#include <thread>
+
+#include <catch2/catch.hpp>
+
+#include "kaacore/tracing.h"
+
+size_t
+count_occurrences(const std::string& text, const std::string& fragment)
+{
+    size_t count = 0;
+    for (auto position = text.find(fragment); position != std::string::npos;
+         position = text.find(fragment, position + 1)) {
+        count++;
+    }
+    return count;
+}
+
+TEST_CASE("test_tracing", "[tracing][no_engine]")
+{
+    kaacore::clear_trace();
+
+#if KAACORE_TRACING
+    SECTION("Scopes")
+    {
+        KAACORE_TRACE_THREAD_NAME("test \"thread\"");
+        {
+            KAACORE_TRACE_SCOPE("test", "outer");
+            KAACORE_TRACE_SCOPE_ARG("test", "inner", "value", 42.5);
+        }
+        std::thread{[]() { KAACORE_TRACE_SCOPE("test", "other_thread"); }}
+            .join();
+
+        const auto trace = kaacore::dump_trace_json();
+        REQUIRE(
+            count_occurrences(
+                trace, "\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"B\""
+            ) == 1
+        );
+        REQUIRE(
+            count_occurrences(
+                trace, "\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"E\""
+            ) == 1
+        );
+        REQUIRE(count_occurrences(trace, "\"args\":{\"value\":42.5}") == 1);
+        REQUIRE(count_occurrences(trace, "\"name\":\"other_thread\"") == 2);
+        REQUIRE(count_occurrences(trace, "test \\\"thread\\\"") == 1);
+    }
+
+    SECTION("Buffer overflow")
+    {
+        {
+            KAACORE_TRACE_SCOPE("test", "outer");
+            for (size_t i = 0; i < kaacore::trace_thread_buffer_size; i++) {
+                KAACORE_TRACE_SCOPE("test", "inner");
+            }
+        }
+        // only latest events are kept, ends of scopes whose beginnings
+        // were overwritten are skipped
+        const auto trace = kaacore::dump_trace_json();
+        REQUIRE(count_occurrences(trace, "\"name\":\"outer\"") == 0);
+        REQUIRE(
+            count_occurrences(
+                trace, "\"name\":\"inner\",\"cat\":\"test\",\"ph\":\"E\""
+            ) == kaacore::trace_thread_buffer_size / 2 - 1
+        );
+    }
+
+    kaacore::clear_trace();
+    REQUIRE(
+        count_occurrences(kaacore::dump_trace_json(), "\"ph\":\"B\"") == 0
+    );
+#else
+    KAACORE_TRACE_SCOPE("test", "compiled_out");
+    REQUIRE(
+        kaacore::dump_trace_json() ==
+        "{\"traceEvents\":[\n],\"displayTimeUnit\":\"ms\"}\n"
+    );
+#endif
+}
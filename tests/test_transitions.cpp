@@ -45,3 +45,125 @@ TEST_CASE("test_nested_infinite_transitions_sequence", "[transitions]")
     REQUIRE(tr_outer->duration.count() == INFINITY);
     REQUIRE(tr_outer->internal_duration.count() == 3.);
 }
+
+TEST_CASE("Test transition slots", "[transitions]")
+{
+    REQUIRE(
+        kaacore::get_transition_slot(kaacore::default_transition_name) ==
+        kaacore::default_transition_slot
+    );
+    const auto slot = kaacore::get_transition_slot("test_slot");
+    REQUIRE(slot != kaacore::default_transition_slot);
+    REQUIRE(kaacore::get_transition_slot("test_slot") == slot);
+    REQUIRE(kaacore::get_transition_slot_name(slot) == "test_slot");
+
+    kaacore::NodeOwnerPtr node = kaacore::make_node();
+    auto transition =
+        kaacore::make_node_transition<kaacore::NodeRotationTransition>(
+            1., 1.s
+        );
+    node->transitions_manager().set("test_slot", transition);
+    REQUIRE(node->transitions_manager().get(slot) == transition);
+    REQUIRE(not node->transition());
+
+    node->transition(transition);
+    REQUIRE(
+        node->transitions_manager().get(kaacore::default_transition_name) ==
+        transition
+    );
+    node->transitions_manager().set(slot, nullptr);
+    REQUIRE(not node->transitions_manager().get("test_slot"));
+    REQUIRE(node->transitions_manager());
+}
+
+TEST_CASE("Test batched attribute transitions", "[transitions]")
+{
+    auto engine = initialize_testing_engine();
+
+    TestingScene scene;
+    scene.update_function = [&scene](auto dt) {
+        kaacore::NodeOwnerPtr tmp_node = kaacore::make_node();
+        auto node = scene.root_node.add_child(tmp_node);
+        node->transition(
+            kaacore::make_node_transition<kaacore::NodePositionTransition>(
+                glm::dvec2{100., 0.}, kaacore::AttributeTransitionMethod::set,
+                1.s, kaacore::TransitionWarping{1, true}
+            )
+        );
+
+        scene.step_simulation(250ms);
+        REQUIRE(scene.batched_transitions.size() == 1);
+        REQUIRE(node->position().x == Approx(25.));
+        scene.step_simulation(750ms);
+        REQUIRE(node->position().x == Approx(100.));
+        scene.step_simulation(500ms);
+        REQUIRE(node->position().x == Approx(50.));
+        scene.step_simulation(500ms);
+        REQUIRE(node->position().x == Approx(0.));
+        REQUIRE(scene.batched_transitions.size() == 0);
+        REQUIRE(not node->transition());
+
+        node->transition(
+            kaacore::make_node_transition<kaacore::NodeRotationTransition>(
+                1., kaacore::AttributeTransitionMethod::add, 1.s
+            )
+        );
+        scene.step_simulation(500ms);
+        REQUIRE(scene.batched_transitions.size() == 1);
+        REQUIRE(node->rotation() == Approx(0.5));
+
+        // replacing transition removes it from batch
+        node->transition(kaacore::make_node_transitions_sequence(
+            {kaacore::make_node_transition<kaacore::NodeScaleTransition>(
+                glm::dvec2{2., 2.}, 1.s
+            )}
+        ));
+        REQUIRE(scene.batched_transitions.size() == 0);
+        scene.step_simulation(500ms);
+        REQUIRE(scene.batched_transitions.size() == 0);
+        REQUIRE(node->scale().x == Approx(1.5));
+
+        node->transition(
+            kaacore::make_node_transition<kaacore::NodeColorTransition>(
+                glm::dvec4{0., 0., 0., 0.}, 1.s
+            )
+        );
+        scene.step_simulation(500ms);
+        REQUIRE(scene.batched_transitions.size() == 1);
+        node.destroy();
+        scene.step_simulation(500ms);
+        REQUIRE(scene.batched_transitions.size() == 0);
+    };
+    scene.run_on_engine(1);
+}
+
+TEST_CASE(
+    "Benchmark batched attribute transitions", "[transitions][.benchmark]"
+)
+{
+    auto engine = initialize_testing_engine();
+
+    TestingScene scene;
+    scene.update_function = [&scene](auto dt) {
+        for (size_t i = 0; i < 20000; i++) {
+            kaacore::NodeOwnerPtr tmp_node = kaacore::make_node();
+            auto node = scene.root_node.add_child(tmp_node);
+            node->transition(
+                kaacore::make_node_transition<kaacore::NodePositionTransition>(
+                    glm::dvec2{i * 1., 100.},
+                    kaacore::AttributeTransitionMethod::set, 1.s,
+                    kaacore::TransitionWarping{0, true},
+                    kaacore::Easing::quadratic_in_out
+                )
+            );
+        }
+        scene.step_simulation(16666us);
+        REQUIRE(scene.batched_transitions.size() == 20000);
+
+        BENCHMARK("step 20000 position transitions")
+        {
+            scene.step_simulation(16666us);
+        };
+    };
+    scene.run_on_engine(1);
+}
@@ -0,0 +1,49 @@
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "kaacore/files.h"
+#include "kaacore/font_cache.h"
+#include "kaacore/fonts.h"
+#include "kaacore/log.h"
+
+// Bakes font atlases into font cache directory, so applications
+// shipping the directory (and pointing KAACORE_FONT_CACHE_DIR to it)
+// can skip SDF rasterization at startup. Embedded default font
+// is always included.
+int
+main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " CACHE_DIRECTORY [FONT_FILE...]"
+                  << std::endl;
+        return 1;
+    }
+
+    kaacore::initialize_logging();
+    const std::string cache_directory = argv[1];
+    kaacore::set_font_cache_directory(cache_directory);
+
+    kaacore::get_default_font();
+    for (int i = 2; i < argc; i++) {
+        try {
+            kaacore::FontData::load(argv[i]);
+            const auto memory = kaacore::map_file(argv[i]);
+            const auto cache_path = kaacore::get_font_cache_path(
+                cache_directory,
+                kaacore::calculate_font_cache_key(memory.get(), memory.size())
+            );
+            if (not std::ifstream{cache_path}) {
+                throw std::runtime_error("cache file was not written");
+            }
+        } catch (const std::exception& exc) {
+            std::cerr << "Failed to prebake font " << argv[i] << ": "
+                      << exc.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Prebaked font: " << argv[i] << std::endl;
+    }
+    return 0;
+}
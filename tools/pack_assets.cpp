@@ -0,0 +1,61 @@
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "kaacore/archives.h"
+#include "kaacore/log.h"
+
+// Packs all files from assets directory into single archive, file
+// names inside archive are paths relative to that directory.
+// Mount it with kaacore::mount_archive to load assets from it.
+int
+main(int argc, char* argv[])
+{
+    bool compress = false;
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (argument == "--compress") {
+            compress = true;
+        } else {
+            arguments.push_back(argument);
+        }
+    }
+    if (arguments.size() != 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--compress] ARCHIVE_FILE ASSETS_DIRECTORY" << std::endl;
+        return 1;
+    }
+
+    kaacore::initialize_logging();
+    const auto& archive_path = arguments[0];
+    const std::filesystem::path assets_directory = arguments[1];
+    try {
+        std::vector<kaacore::ArchiveInput> inputs;
+        for (const auto& entry :
+             std::filesystem::recursive_directory_iterator(assets_directory)) {
+            if (not entry.is_regular_file()) {
+                continue;
+            }
+            inputs.push_back(
+                {entry.path()
+                     .lexically_relative(assets_directory)
+                     .generic_string(),
+                 entry.path().string()}
+            );
+        }
+        if (not kaacore::write_archive(archive_path, inputs, compress)) {
+            std::cerr << "Failed to write archive: " << archive_path
+                      << std::endl;
+            return 1;
+        }
+        std::cout << "Packed " << inputs.size() << " files into "
+                  << archive_path << std::endl;
+    } catch (const std::exception& exc) {
+        std::cerr << "Failed to pack assets: " << exc.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
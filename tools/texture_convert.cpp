@@ -0,0 +1,107 @@
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <bimg/bimg.h>
+#include <bimg/encode.h>
+#include <bx/allocator.h>
+#include <bx/error.h>
+#include <bx/file.h>
+
+#include "kaacore/log.h"
+#include "kaacore/textures.h"
+
+// Converts image into KTX texture stored in GPU-compressed format
+// (e.g. BC1, BC3, BC7, ETC2, ETC2A, ASTC4x4, ASTC8x8), which is
+// uploaded by ImageTexture::load without decoding. Runtime falls back
+// to decoding it when GPU doesn't support the format.
+int
+main(int argc, char* argv[])
+{
+    bool generate_mips = false;
+    std::vector<std::string> arguments;
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        if (argument == "--mips") {
+            generate_mips = true;
+        } else {
+            arguments.push_back(argument);
+        }
+    }
+    if (arguments.size() != 3) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--mips] FORMAT INPUT_IMAGE OUTPUT_KTX_FILE"
+                  << std::endl;
+        return 1;
+    }
+
+    kaacore::initialize_logging();
+    const auto format = bimg::getFormat(arguments[0].c_str());
+    const auto& input_path = arguments[1];
+    const auto& output_path = arguments[2];
+    if (format == bimg::TextureFormat::Enum::Unknown or
+        format == bimg::TextureFormat::Enum::Count) {
+        std::cerr << "Unknown texture format: " << arguments[0] << std::endl;
+        return 1;
+    }
+
+    bx::DefaultAllocator allocator;
+    bimg::ImageContainer* input;
+    try {
+        input = kaacore::load_image(input_path);
+    } catch (const std::exception& exc) {
+        std::cerr << "Failed to load image " << input_path << ": "
+                  << exc.what() << std::endl;
+        return 1;
+    }
+    bimg::ImageContainer* rgba_input =
+        generate_mips
+            ? kaacore::generate_image_mips(input)
+            : kaacore::convert_image(input, bimg::TextureFormat::Enum::RGBA8);
+    bimg::imageFree(input);
+
+    bimg::ImageContainer* output = bimg::imageAlloc(
+        &allocator, format, rgba_input->m_width, rgba_input->m_height, 1, 1,
+        false, generate_mips
+    );
+    bx::Error error;
+    for (uint8_t lod = 0; lod < output->m_numMips and error.isOk(); lod++) {
+        bimg::ImageMip source_mip;
+        bimg::imageGetRawData(
+            *rgba_input, 0, lod, rgba_input->m_data, rgba_input->m_size,
+            source_mip
+        );
+        bimg::ImageMip mip;
+        bimg::imageGetRawData(
+            *output, 0, lod, output->m_data, output->m_size, mip
+        );
+        bimg::imageEncodeFromRgba8(
+            &allocator, const_cast<uint8_t*>(mip.m_data), source_mip.m_data,
+            source_mip.m_width, source_mip.m_height, 1, format,
+            bimg::Quality::Default, &error
+        );
+    }
+    bimg::imageFree(rgba_input);
+    if (error.isOk()) {
+        bx::FileWriter writer;
+        if (bx::open(&writer, output_path.c_str(), false, &error)) {
+            bimg::imageWriteKtx(
+                &writer, *output, output->m_data, output->m_size, &error
+            );
+            bx::close(&writer);
+        }
+    }
+    bimg::imageFree(output);
+    if (not error.isOk()) {
+        const auto message = error.getMessage();
+        std::cerr << "Failed to convert image " << input_path << ": "
+                  << std::string(message.getPtr(), message.getLength())
+                  << std::endl;
+        return 1;
+    }
+
+    std::cout << "Converted image: " << input_path << " -> " << output_path
+              << " (" << bimg::getName(format) << ")" << std::endl;
+    return 0;
+}